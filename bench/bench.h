@@ -0,0 +1,77 @@
+/* collection - A generic data structure and algorithms library
+ * Copyright (C) 2025 Yixiang Qiu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef COL_BENCH_H
+#define COL_BENCH_H
+
+/* Helpers shared by the benchmark drivers */
+
+#include <pthread.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+/* Monotonic time in nanoseconds */
+static inline uint64_t bench_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/* Online CPUs, at least 1 */
+static inline int bench_ncpu(void)
+{
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  return n > 0 ? (int)n : 1;
+}
+
+/* Pin the calling thread to cpu modulo the online CPUs. Returns -1 where
+   affinity is not supported, the thread then runs unpinned. */
+static inline int bench_pin(int cpu)
+{
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu % bench_ncpu(), &set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) ? -1 : 0;
+#else
+  (void)cpu;
+  return -1;
+#endif
+}
+
+/* Next thread count of a sweep 1, 2, 4, ... that ends exactly on max */
+static inline int bench_step(int t, int max)
+{
+  return t < max && 2 * t > max ? max : 2 * t;
+}
+
+/* xorshift32 stream, state must be non-zero */
+static inline uint32_t bench_rand(uint32_t *state)
+{
+  uint32_t x = *state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return *state = x;
+}
+
+#endif
@@ -0,0 +1,172 @@
+/* collection - A generic data structure and algorithms library
+ * Copyright (C) 2025 Yixiang Qiu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* bqueue throughput and push-to-pop latency for pools of 1, 2, 4, ...
+   producers and as many consumers, on a bounded and an unbounded queue. Every
+   item carries the time it was pushed, consumers record how long it waited
+   and the percentiles are taken over all items.
+
+   usage: bqueue [maxpool [items per producer [capacity]]] */
+
+#include "bench.h"
+#include <bqueue.h>
+#include <sort.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector.h>
+
+struct item {
+  uint64_t pushed; /* bench_ns() just before bqueue_enq */
+  uint64_t seq;
+};
+
+struct worker {
+  pthread_t tid;
+  struct bqueue *bq;
+  pthread_barrier_t *start;
+  long items;
+  uint64_t id;
+  uint64_t sum;
+  struct vector lat; /* Latencies in ns, consumers only */
+};
+
+static int cmp_u64(void *a, void *b)
+{
+  uint64_t x = *(uint64_t *)a, y = *(uint64_t *)b;
+  return (x > y) - (x < y);
+}
+
+/* Items are numbered from 1 over all producers, so the consumed sum is
+   known */
+static void *produce(void *arg)
+{
+  struct worker *w = arg;
+  pthread_barrier_wait(w->start);
+  uint64_t first = w->id * (uint64_t)w->items + 1;
+  for (long i = 0; i < w->items; i++) {
+    struct item it = {bench_ns(), first + (uint64_t)i};
+    if (bqueue_enq(w->bq, &it) == -1)
+      break;
+  }
+  return NULL;
+}
+
+static void *consume(void *arg)
+{
+  struct worker *w = arg;
+  struct item it;
+  pthread_barrier_wait(w->start);
+  while (bqueue_deq(w->bq, &it) == 0) {
+    uint64_t lat = bench_ns() - it.pushed;
+    w->sum += it.seq;
+    if (vec_pushback(&w->lat, &lat) == -1)
+      break;
+  }
+  return NULL;
+}
+
+/* Run one pool and print its line, returns -1 on error or if the consumed
+   items do not add up */
+static int run(int pool, long items, size_t cap)
+{
+  struct worker *w = calloc((size_t)pool * 2, sizeof(*w));
+  struct vector all;
+  struct bqueue bq;
+  pthread_barrier_t start;
+  uint64_t total = (uint64_t)pool * (uint64_t)items, sum = 0;
+  int i, rc = 0;
+
+  if (!w || bqueue_init(&bq, sizeof(struct item), cap, NULL) == -1) {
+    free(w);
+    return -1;
+  }
+  vec_init(&all, sizeof(uint64_t), NULL);
+  pthread_barrier_init(&start, NULL, (unsigned)pool * 2 + 1);
+  for (i = 0; i < pool * 2; i++) {
+    w[i] = (struct worker){.bq = &bq,
+                           .start = &start,
+                           .items = items,
+                           .id = (uint64_t)i / 2};
+    vec_init(&w[i].lat, sizeof(uint64_t), NULL);
+    if (pthread_create(&w[i].tid, NULL, i % 2 ? consume : produce, &w[i])) {
+      fprintf(stderr, "pthread_create failed\n");
+      exit(1);
+    }
+  }
+  /* Workers are released only once this thread reaches the barrier, so the
+     clock starts before any of them */
+  uint64_t t0 = bench_ns();
+  pthread_barrier_wait(&start);
+  for (i = 0; i < pool * 2; i += 2)
+    pthread_join(w[i].tid, NULL);
+  /* Consumers drain what is left and stop */
+  bqueue_close(&bq);
+  for (i = 1; i < pool * 2; i += 2)
+    pthread_join(w[i].tid, NULL);
+  uint64_t ns = bench_ns() - t0;
+
+  for (i = 1; i < pool * 2; i += 2) {
+    struct vector *lat = &w[i].lat;
+    sum += w[i].sum;
+    for (size_t j = 0; j < vec_size(lat) && rc == 0; j++)
+      rc = vec_pushback(&all, vec_at(lat, j));
+  }
+  if (rc == 0 && (vec_size(&all) != total || sum != total * (total + 1) / 2))
+    rc = -1;
+  if (rc == 0) {
+    uint64_t *lat = (uint64_t *)vec_raw(&all);
+    size_t n = vec_size(&all);
+    sort(lat, n, sizeof(uint64_t), cmp_u64);
+    printf("%6d %10s %12.2f", pool, cap ? "bounded" : "unbounded",
+           (double)total / ((double)ns / 1e3));
+    printf(" %10.1f %10.1f %10.1f %10.1f\n", (double)lat[n / 2] / 1e3,
+           (double)lat[n * 9 / 10] / 1e3, (double)lat[n * 99 / 100] / 1e3,
+           (double)lat[n * 999 / 1000] / 1e3);
+  }
+
+  for (i = 0; i < pool * 2; i++)
+    vec_fini(&w[i].lat);
+  vec_fini(&all);
+  pthread_barrier_destroy(&start);
+  bqueue_fini(&bq);
+  free(w);
+  return rc;
+}
+
+int main(int argc, char *argv[])
+{
+  int maxpool = argc > 1 ? atoi(argv[1]) : 8;
+  long items = argc > 2 ? atol(argv[2]) : 100000;
+  size_t cap = argc > 3 ? (size_t)atol(argv[3]) : 256;
+
+  if (maxpool < 1 || items < 1 || cap < 1) {
+    fprintf(stderr, "usage: %s [maxpool [items per producer [capacity]]]\n",
+            argv[0]);
+    return 1;
+  }
+  printf("%ld items per producer, bounded capacity %zu, latency in us\n",
+         items, cap);
+  printf("%6s %10s %12s %10s %10s %10s %10s\n", "pool", "queue", "items M/s",
+         "p50", "p90", "p99", "p99.9");
+  for (int p = 1; p <= maxpool; p = bench_step(p, maxpool)) {
+    if (run(p, items, cap) == -1 || run(p, items, 0) == -1) {
+      fprintf(stderr, "bqueue lost items\n");
+      return 1;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,281 @@
+/* collection - A generic data structure and algorithms library
+ * Copyright (C) 2025 Yixiang Qiu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* Contention on mpmcq against a struct queue behind one mutex, for 1, 2, 4,
+   ... producers and as many consumers, moving 8-byte items one at a time and
+   in batches. The locked queue is held to the same capacity so producers
+   cannot run ahead of the consumers.
+
+   usage: mpmcq [maxpairs [items per producer [capacity [batch]]]] */
+
+#include "bench.h"
+#include <mpmcq.h>
+#include <queue.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <util.h>
+
+/* The two queues behind one interface, enq and deq move up to n items and
+   return how many they moved */
+struct ops {
+  const char *name;
+  void *(*init)(size_t cap);
+  void (*fini)(void *q);
+  size_t (*enq)(void *q, uint64_t *v, size_t n);
+  size_t (*deq)(void *q, uint64_t *v, size_t n);
+};
+
+struct locked {
+  pthread_mutex_t lock;
+  struct queue queue;
+  size_t cap;
+};
+
+struct shared {
+  const struct ops *ops;
+  void *q;
+  size_t batch;
+  long items;
+  atomic_int done;
+  pthread_barrier_t start;
+};
+
+struct worker {
+  _Alignas(COL_CACHELINE) atomic_long count; /* Items consumed so far */
+  pthread_t tid;
+  struct shared *sh;
+  uint64_t id;
+  uint64_t sum;
+};
+
+static void *mpmc_init(size_t cap)
+{
+  struct mpmcq *q = malloc(sizeof(*q));
+  if (q && mpmcq_init(q, sizeof(uint64_t), cap, NULL) == -1) {
+    free(q);
+    return NULL;
+  }
+  return q;
+}
+
+static void mpmc_fini(void *q)
+{
+  mpmcq_fini(q);
+  free(q);
+}
+
+static size_t mpmc_enq(void *q, uint64_t *v, size_t n)
+{
+  if (n == 1)
+    return mpmcq_try_enq(q, v) == 0;
+  return mpmcq_try_enq_n(q, v, n);
+}
+
+static size_t mpmc_deq(void *q, uint64_t *v, size_t n)
+{
+  if (n == 1)
+    return mpmcq_try_deq(q, v) == 0;
+  return mpmcq_try_deq_n(q, v, n);
+}
+
+static void *locked_init(size_t cap)
+{
+  struct locked *lq = malloc(sizeof(*lq));
+  if (!lq)
+    return NULL;
+  if (queue_init(&lq->queue, sizeof(uint64_t), NULL) == -1) {
+    free(lq);
+    return NULL;
+  }
+  pthread_mutex_init(&lq->lock, NULL);
+  lq->cap = cap;
+  return lq;
+}
+
+static void locked_fini(void *q)
+{
+  struct locked *lq = q;
+  queue_fini(&lq->queue);
+  pthread_mutex_destroy(&lq->lock);
+  free(lq);
+}
+
+static size_t locked_enq(void *q, uint64_t *v, size_t n)
+{
+  struct locked *lq = q;
+  size_t m = 0;
+  pthread_mutex_lock(&lq->lock);
+  while (m < n && queue_size(&lq->queue) < lq->cap &&
+         queue_enq(&lq->queue, &v[m]) == 0)
+    m++;
+  pthread_mutex_unlock(&lq->lock);
+  return m;
+}
+
+static size_t locked_deq(void *q, uint64_t *v, size_t n)
+{
+  struct locked *lq = q;
+  size_t m = 0;
+  pthread_mutex_lock(&lq->lock);
+  while (m < n && queue_deq(&lq->queue, &v[m]) == 0)
+    m++;
+  pthread_mutex_unlock(&lq->lock);
+  return m;
+}
+
+static const struct ops queues[] = {
+    {"mpmcq", mpmc_init, mpmc_fini, mpmc_enq, mpmc_deq},
+    {"queue+mutex", locked_init, locked_fini, locked_enq, locked_deq},
+};
+
+/* Items are numbered from 1 per producer, so the consumed sum is known */
+static void *produce(void *arg)
+{
+  struct worker *w = arg;
+  struct shared *sh = w->sh;
+  uint64_t buf[256];
+
+  pthread_barrier_wait(&sh->start);
+  for (long i = 0; i < sh->items;) {
+    size_t n = sh->batch;
+    if ((long)n > sh->items - i)
+      n = (size_t)(sh->items - i);
+    for (size_t j = 0; j < n; j++)
+      buf[j] = w->id * (uint64_t)sh->items + (uint64_t)i + j + 1;
+    for (size_t put = 0; put < n;) {
+      size_t m = sh->ops->enq(sh->q, buf + put, n - put);
+      if (!m)
+        sched_yield();
+      put += m;
+    }
+    i += (long)n;
+  }
+  return NULL;
+}
+
+static void *consume(void *arg)
+{
+  struct worker *w = arg;
+  struct shared *sh = w->sh;
+  uint64_t buf[256];
+  long count = 0;
+
+  pthread_barrier_wait(&sh->start);
+  while (!atomic_load_explicit(&sh->done, memory_order_acquire)) {
+    size_t m = sh->ops->deq(sh->q, buf, sh->batch);
+    if (!m) {
+      sched_yield();
+      continue;
+    }
+    for (size_t j = 0; j < m; j++)
+      w->sum += buf[j];
+    count += (long)m;
+    atomic_store_explicit(&w->count, count, memory_order_relaxed);
+  }
+  return NULL;
+}
+
+/* Move pairs * items items and return million items per second, or -1 on
+   error or if the consumed items do not add up */
+static double run(const struct ops *ops, int pairs, long items, size_t cap,
+                  size_t batch)
+{
+  size_t wsz = (size_t)pairs * 2 * sizeof(struct worker);
+  struct worker *w = aligned_alloc(_Alignof(struct worker), wsz);
+  struct shared sh = {
+      .ops = ops, .q = ops->init(cap), .batch = batch, .items = items};
+  long total = (long)pairs * items, seen;
+  uint64_t sum = 0;
+  int i;
+
+  if (!w || !sh.q) {
+    free(w);
+    if (sh.q)
+      ops->fini(sh.q);
+    return -1;
+  }
+  memset(w, 0, wsz);
+  atomic_init(&sh.done, 0);
+  pthread_barrier_init(&sh.start, NULL, (unsigned)pairs * 2 + 1);
+  for (i = 0; i < pairs * 2; i++) {
+    w[i].sh = &sh;
+    w[i].id = (uint64_t)i / 2;
+    atomic_init(&w[i].count, 0);
+    if (pthread_create(&w[i].tid, NULL, i % 2 ? consume : produce, &w[i])) {
+      fprintf(stderr, "pthread_create failed\n");
+      exit(1);
+    }
+  }
+  /* Workers are released only once this thread reaches the barrier, so the
+     clock starts before any of them */
+  uint64_t t0 = bench_ns();
+  pthread_barrier_wait(&sh.start);
+  do {
+    sched_yield();
+    seen = 0;
+    for (i = 1; i < pairs * 2; i += 2)
+      seen += atomic_load_explicit(&w[i].count, memory_order_relaxed);
+  } while (seen < total);
+  uint64_t ns = bench_ns() - t0;
+  atomic_store_explicit(&sh.done, 1, memory_order_release);
+
+  for (i = 0; i < pairs * 2; i++) {
+    pthread_join(w[i].tid, NULL);
+    if (i % 2)
+      sum += w[i].sum;
+  }
+  pthread_barrier_destroy(&sh.start);
+  ops->fini(sh.q);
+  free(w);
+  if (sum != (uint64_t)total * ((uint64_t)total + 1) / 2)
+    return -1;
+  return (double)total / ((double)ns / 1e3);
+}
+
+int main(int argc, char *argv[])
+{
+  int maxpairs = argc > 1 ? atoi(argv[1]) : 8;
+  long items = argc > 2 ? atol(argv[2]) : 200000;
+  size_t cap = argc > 3 ? (size_t)atol(argv[3]) : 1024;
+  size_t batch = argc > 4 ? (size_t)atol(argv[4]) : 32;
+
+  if (maxpairs < 1 || items < 1 || cap < 2 || batch < 2 || batch > 256) {
+    fprintf(stderr,
+            "usage: %s [maxpairs [items per producer [capacity [batch]]]]\n",
+            argv[0]);
+    return 1;
+  }
+  printf("%ld items per producer, capacity %zu, batch %zu\n", items, cap,
+         batch);
+  printf("%6s %14s %12s %12s\n", "pairs", "queue", "single M/s",
+         "batch M/s");
+  for (int p = 1; p <= maxpairs; p = bench_step(p, maxpairs)) {
+    for (size_t i = 0; i < sizeof(queues) / sizeof(queues[0]); i++) {
+      double one = run(&queues[i], p, items, cap, 1);
+      double many = run(&queues[i], p, items, cap, batch);
+      if (one < 0 || many < 0) {
+        fprintf(stderr, "%s lost items\n", queues[i].name);
+        return 1;
+      }
+      printf("%6d %14s %12.2f %12.2f\n", p, queues[i].name, one, many);
+    }
+  }
+  return 0;
+}
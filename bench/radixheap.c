@@ -0,0 +1,127 @@
+/* collection - A generic data structure and algorithms library
+ * Copyright (C) 2025 Yixiang Qiu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* radixheap against struct heap on a Dijkstra-like monotone workload: every
+   pop of key k pushes a few entries keyed k plus a random edge weight, until
+   the given number of pops. Both queues see the same key sequence, for
+   several maximum edge weights.
+
+   usage: radixheap [pops [fanout]] */
+
+#include "bench.h"
+#include <heap.h>
+#include <radixheap.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* A heap entry carries its key, the radix heap keeps the key itself and only
+   stores the node */
+struct entry {
+  uint64_t key;
+  uint32_t node;
+};
+
+static int cmp_entry(void *a, void *b)
+{
+  uint64_t x = ((struct entry *)a)->key, y = ((struct entry *)b)->key;
+  return (x > y) - (x < y);
+}
+
+/* Run the workload and return million pops per second, or -1 on error. The
+   sum of popped keys goes to check so both queues can be compared. */
+static double run_heap(long pops, int fanout, uint32_t maxw, uint64_t *check)
+{
+  struct heap h;
+  struct entry e = {0, 0};
+  uint32_t seed = 88172645u;
+  uint64_t sum = 0;
+
+  if (heap_init(&h, sizeof(e), cmp_entry, NULL) == -1 ||
+      heap_push(&h, &e) == -1)
+    return -1;
+  uint64_t t0 = bench_ns();
+  for (long i = 0; i < pops && !heap_empty(&h); i++) {
+    heap_pop(&h, &e);
+    sum += e.key;
+    for (int j = 0; j < fanout; j++) {
+      struct entry f = {e.key + bench_rand(&seed) % maxw, e.node + 1};
+      if (heap_push(&h, &f) == -1) {
+        heap_fini(&h);
+        return -1;
+      }
+    }
+  }
+  uint64_t ns = bench_ns() - t0;
+  heap_fini(&h);
+  *check = sum;
+  return (double)pops / ((double)ns / 1e3);
+}
+
+static double run_radix(long pops, int fanout, uint32_t maxw, uint64_t *check)
+{
+  struct radixheap rh;
+  uint32_t node = 0, seed = 88172645u;
+  uint64_t key, sum = 0;
+
+  if (radixheap_init(&rh, sizeof(node), NULL) == -1 ||
+      radixheap_push(&rh, 0, &node) == -1)
+    return -1;
+  uint64_t t0 = bench_ns();
+  for (long i = 0; i < pops && !radixheap_empty(&rh); i++) {
+    radixheap_pop(&rh, &key, &node);
+    sum += key;
+    for (int j = 0; j < fanout; j++) {
+      uint32_t next = node + 1;
+      if (radixheap_push(&rh, key + bench_rand(&seed) % maxw, &next) == -1) {
+        radixheap_fini(&rh);
+        return -1;
+      }
+    }
+  }
+  uint64_t ns = bench_ns() - t0;
+  radixheap_fini(&rh);
+  *check = sum;
+  return (double)pops / ((double)ns / 1e3);
+}
+
+int main(int argc, char *argv[])
+{
+  static const uint32_t weights[] = {16, 1u << 10, 1u << 20, UINT32_MAX};
+  long pops = argc > 1 ? atol(argv[1]) : 2000000;
+  int fanout = argc > 2 ? atoi(argv[2]) : 2;
+
+  /* With fanout 1 the queue never grows, which is no workload */
+  if (pops < 1 || fanout < 2) {
+    fprintf(stderr, "usage: %s [pops [fanout >= 2]]\n", argv[0]);
+    return 1;
+  }
+  printf("%ld pops, %d pushes per pop\n", pops, fanout);
+  printf("%12s %16s %16s %8s\n", "max weight", "heap Mops/s",
+         "radixheap Mops/s", "ratio");
+  for (size_t i = 0; i < sizeof(weights) / sizeof(weights[0]); i++) {
+    uint64_t hsum, rsum;
+    double h = run_heap(pops, fanout, weights[i], &hsum);
+    double r = run_radix(pops, fanout, weights[i], &rsum);
+    if (h < 0 || r < 0 || hsum != rsum) {
+      fprintf(stderr, "queues disagree\n");
+      return 1;
+    }
+    printf("%12lu %16.2f %16.2f %8.2f\n", (unsigned long)weights[i], h, r,
+           r / h);
+  }
+  return 0;
+}
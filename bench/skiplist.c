@@ -0,0 +1,189 @@
+/* collection - A generic data structure and algorithms library
+ * Copyright (C) 2025 Yixiang Qiu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* Scaling of the lock-free skiplist against an avltree behind one mutex, on
+   the same mixed find/insert/remove workload for 1, 2, 4, ... threads.
+
+   usage: skiplist [maxthreads [ops per thread [keys [find percent]]]] */
+
+#include <avltree.h>
+#include <pthread.h>
+#include <skiplist.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Keys are integers stored in the pointer, so neither map allocates keys and
+   only the structure itself is measured */
+#define KEY(v) ((void *)(uintptr_t)((v) + 1))
+
+struct locked {
+  pthread_mutex_t lock;
+  struct avltree tree;
+};
+
+struct worker {
+  pthread_t tid;
+  pthread_barrier_t *start;
+  void *map;
+  unsigned seed;
+  long ops;
+  unsigned keys;
+  unsigned find;
+};
+
+static int cmp(void *a, void *b)
+{
+  uintptr_t x = (uintptr_t)a, y = (uintptr_t)b;
+  return (x > y) - (x < y);
+}
+
+/* Next operation of a worker: a key and whether it is a find, an insert or a
+   remove, the writes split evenly so the map stays about half full */
+static unsigned next(struct worker *w, int *op)
+{
+  w->seed = w->seed * 1103515245u + 12345u;
+  unsigned r = (w->seed >> 8) % 100;
+  *op = r < w->find ? 0 : (r - w->find) % 2 + 1;
+  w->seed = w->seed * 1103515245u + 12345u;
+  return (w->seed >> 4) % w->keys;
+}
+
+static void *run_skiplist(void *arg)
+{
+  struct worker *w = arg;
+  struct skiplist *sl = w->map;
+  pthread_barrier_wait(w->start);
+  for (long i = 0; i < w->ops; i++) {
+    int op;
+    unsigned k = next(w, &op);
+    if (op == 0)
+      skiplist_find(sl, KEY(k));
+    else if (op == 1)
+      skiplist_insert(sl, KEY(k), NULL);
+    else
+      skiplist_remove(sl, KEY(k), NULL);
+  }
+  return NULL;
+}
+
+static void *run_locked(void *arg)
+{
+  struct worker *w = arg;
+  struct locked *lt = w->map;
+  pthread_barrier_wait(w->start);
+  for (long i = 0; i < w->ops; i++) {
+    int op;
+    unsigned k = next(w, &op);
+    pthread_mutex_lock(&lt->lock);
+    if (op == 0)
+      avltree_find(&lt->tree, KEY(k));
+    else if (op == 1)
+      avltree_insert(&lt->tree, KEY(k), NULL);
+    else
+      avltree_remove(&lt->tree, KEY(k), NULL);
+    pthread_mutex_unlock(&lt->lock);
+  }
+  return NULL;
+}
+
+/* Run n workers on map and return the throughput in million operations per
+   second, or -1 if out of memory */
+static double measure(void *(*fn)(void *), void *map, int n, long ops,
+                      unsigned keys, unsigned find)
+{
+  struct worker *w = calloc((size_t)n, sizeof(*w));
+  pthread_barrier_t start;
+  struct timespec t0, t1;
+  int i;
+
+  if (!w)
+    return -1;
+  pthread_barrier_init(&start, NULL, (unsigned)n + 1);
+  for (i = 0; i < n; i++) {
+    w[i] = (struct worker){.start = &start,
+                           .map = map,
+                           .seed = (unsigned)i * 2654435761u + 1,
+                           .ops = ops,
+                           .keys = keys,
+                           .find = find};
+    if (pthread_create(&w[i].tid, NULL, fn, &w[i]) != 0) {
+      fprintf(stderr, "pthread_create failed\n");
+      exit(1);
+    }
+  }
+  /* Workers are released only once this thread reaches the barrier, so the
+     clock starts before any of them */
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  pthread_barrier_wait(&start);
+  for (i = 0; i < n; i++)
+    pthread_join(w[i].tid, NULL);
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  pthread_barrier_destroy(&start);
+  free(w);
+
+  double sec = (double)(t1.tv_sec - t0.tv_sec) +
+               (double)(t1.tv_nsec - t0.tv_nsec) / 1e9;
+  return (double)n * (double)ops / sec / 1e6;
+}
+
+int main(int argc, char *argv[])
+{
+  struct skiplist_fns sfns = {cmp, NULL, NULL};
+  struct avltree_fns afns = {cmp, NULL, NULL};
+  int maxthreads = argc > 1 ? atoi(argv[1]) : 8;
+  long ops = argc > 2 ? atol(argv[2]) : 500000;
+  unsigned keys = argc > 3 ? (unsigned)atol(argv[3]) : 1u << 16;
+  unsigned find = argc > 4 ? (unsigned)atoi(argv[4]) : 80;
+
+  if (maxthreads < 1 || maxthreads > SKIPLIST_NSLOT || ops < 1 || !keys ||
+      find > 100) {
+    fprintf(stderr,
+            "usage: %s [maxthreads [ops per thread [keys [find percent]]]]\n",
+            argv[0]);
+    return 1;
+  }
+  printf("%ld ops per thread, %u keys, %u%% finds\n", ops, keys, find);
+  printf("%8s %16s %16s %8s\n", "threads", "skiplist Mops/s", "avltree Mops/s",
+         "ratio");
+
+  for (int n = 1; n <= maxthreads; n *= 2) {
+    struct skiplist sl;
+    struct locked lt;
+
+    /* Both maps start half full with the same keys */
+    if (skiplist_init(&sl, &sfns) == -1 || avltree_init(&lt.tree, &afns) == -1)
+      return 1;
+    pthread_mutex_init(&lt.lock, NULL);
+    for (unsigned k = 0; k < keys; k += 2) {
+      skiplist_insert(&sl, KEY(k), NULL);
+      avltree_insert(&lt.tree, KEY(k), NULL);
+    }
+
+    double s = measure(run_skiplist, &sl, n, ops, keys, find);
+    double a = measure(run_locked, &lt, n, ops, keys, find);
+    if (s < 0 || a < 0)
+      return 1;
+    printf("%8d %16.2f %16.2f %8.2f\n", n, s, a, s / a);
+
+    skiplist_fini(&sl);
+    avltree_fini(&lt.tree);
+    pthread_mutex_destroy(&lt.lock);
+  }
+  return 0;
+}
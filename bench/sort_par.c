@@ -0,0 +1,128 @@
+/* collection - A generic data structure and algorithms library
+ * Copyright (C) 2025 Yixiang Qiu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* Scaling of sort_par from 1 thread up to the online CPUs (doubling, then the
+   CPU count itself) against single-threaded sort, on one fixed random input
+   of 4-byte keys and of 32-byte records keyed by their first 8 bytes.
+
+   usage: sort_par [elements [maxthreads [repeats]]] */
+
+#include "bench.h"
+#include <sort.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct record {
+  uint64_t key;
+  char payload[24];
+};
+
+static int cmp_int(void *a, void *b)
+{
+  int x = *(int *)a, y = *(int *)b;
+  return (x > y) - (x < y);
+}
+
+static int cmp_record(void *a, void *b)
+{
+  uint64_t x = ((struct record *)a)->key, y = ((struct record *)b)->key;
+  return (x > y) - (x < y);
+}
+
+/* Best of repeats, in milliseconds, sorting a fresh copy of src each time.
+   nthreads 0 times sort. Returns -1 on a failed or wrong sort. */
+static double run(const void *src, void *work, size_t n, size_t sz,
+                  int (*cmp)(void *, void *), size_t nthreads, int repeats)
+{
+  double best = -1;
+  for (int r = 0; r < repeats; r++) {
+    memcpy(work, src, n * sz);
+    uint64_t t0 = bench_ns();
+    int rc = nthreads ? sort_par(work, n, sz, cmp, nthreads)
+                      : sort(work, n, sz, cmp);
+    double ms = (double)(bench_ns() - t0) / 1e6;
+    if (rc != 0)
+      return -1;
+    for (size_t i = 1; i < n; i++) {
+      if (cmp((char *)work + (i - 1) * sz, (char *)work + i * sz) > 0)
+        return -1;
+    }
+    if (best < 0 || ms < best)
+      best = ms;
+  }
+  return best;
+}
+
+static int sweep(const char *name, const void *src, size_t n, size_t sz,
+                 int (*cmp)(void *, void *), int maxthreads, int repeats)
+{
+  void *work = malloc(n * sz);
+  if (!work)
+    return -1;
+  double base = run(src, work, n, sz, cmp, 0, repeats);
+  if (base < 0) {
+    free(work);
+    return -1;
+  }
+  printf("%s, %zu elements\n", name, n);
+  printf("%8s %12s %10s\n", "threads", "ms", "speedup");
+  printf("%8s %12.1f %10.2f\n", "sort", base, 1.0);
+  for (int t = 1; t <= maxthreads; t = bench_step(t, maxthreads)) {
+    double ms = run(src, work, n, sz, cmp, (size_t)t, repeats);
+    if (ms < 0) {
+      free(work);
+      return -1;
+    }
+    printf("%8d %12.1f %10.2f\n", t, ms, base / ms);
+  }
+  printf("\n");
+  free(work);
+  return 0;
+}
+
+int main(int argc, char *argv[])
+{
+  size_t n = argc > 1 ? (size_t)atol(argv[1]) : (size_t)1 << 22;
+  int maxthreads = argc > 2 ? atoi(argv[2]) : bench_ncpu();
+  int repeats = argc > 3 ? atoi(argv[3]) : 3;
+  uint32_t seed = 2463534242u;
+
+  if (n < 2 || maxthreads < 1 || repeats < 1) {
+    fprintf(stderr, "usage: %s [elements [maxthreads [repeats]]]\n", argv[0]);
+    return 1;
+  }
+
+  int *ints = malloc(n * sizeof(int));
+  struct record *recs = malloc(n * sizeof(struct record));
+  if (!ints || !recs)
+    return 1;
+  for (size_t i = 0; i < n; i++) {
+    ints[i] = (int)bench_rand(&seed);
+    recs[i].key = (uint64_t)bench_rand(&seed) << 32 | bench_rand(&seed);
+    memset(recs[i].payload, (int)i, sizeof(recs[i].payload));
+  }
+
+  int rc = sweep("int", ints, n, sizeof(int), cmp_int, maxthreads, repeats) ||
+           sweep("32-byte record", recs, n, sizeof(struct record), cmp_record,
+                 maxthreads, repeats);
+  if (rc)
+    fprintf(stderr, "sort failed\n");
+  free(ints);
+  free(recs);
+  return rc ? 1 : 0;
+}
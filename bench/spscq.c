@@ -0,0 +1,178 @@
+/* collection - A generic data structure and algorithms library
+ * Copyright (C) 2025 Yixiang Qiu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* spscq throughput between two cores: the producer is pinned to one CPU and
+   the consumer to another, and 8-byte items are moved one at a time with
+   spscq_enq/spscq_deq and in batches with spscq_enq_n/spscq_deq_n.
+
+   usage: spscq [items [capacity [producer cpu [consumer cpu]]]] */
+
+#include "bench.h"
+#include <sched.h>
+#include <spscq.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+struct side {
+  pthread_t tid;
+  struct spscq *q;
+  pthread_barrier_t *start;
+  long items;
+  size_t batch; /* 1 uses the single element calls */
+  int cpu;
+  int pinned;
+  uint64_t sum;
+};
+
+/* Give the other side a chance when both share a CPU, otherwise just spin */
+static void backoff(unsigned *fails)
+{
+  if (++*fails % 1024 == 0)
+    sched_yield();
+}
+
+static void *produce(void *arg)
+{
+  struct side *s = arg;
+  uint64_t buf[1024];
+  unsigned fails = 0;
+
+  s->pinned = bench_pin(s->cpu) == 0;
+  pthread_barrier_wait(s->start);
+  if (s->batch == 1) {
+    for (uint64_t v = 1; v <= (uint64_t)s->items;) {
+      if (spscq_enq(s->q, &v) == 0)
+        v++;
+      else
+        backoff(&fails);
+    }
+    return NULL;
+  }
+  for (long i = 0; i < s->items;) {
+    size_t n = s->batch;
+    if ((long)n > s->items - i)
+      n = (size_t)(s->items - i);
+    for (size_t j = 0; j < n; j++)
+      buf[j] = (uint64_t)i + j + 1;
+    for (size_t put = 0; put < n;) {
+      size_t m = spscq_enq_n(s->q, buf + put, n - put);
+      if (!m)
+        backoff(&fails);
+      put += m;
+    }
+    i += (long)n;
+  }
+  return NULL;
+}
+
+static void *consume(void *arg)
+{
+  struct side *s = arg;
+  uint64_t buf[1024], v, sum = 0;
+  unsigned fails = 0;
+
+  s->pinned = bench_pin(s->cpu) == 0;
+  pthread_barrier_wait(s->start);
+  for (long got = 0; got < s->items;) {
+    if (s->batch == 1) {
+      if (spscq_deq(s->q, &v) == 0) {
+        sum += v;
+        got++;
+      } else
+        backoff(&fails);
+      continue;
+    }
+    size_t m = spscq_deq_n(s->q, buf, s->batch);
+    if (!m)
+      backoff(&fails);
+    for (size_t j = 0; j < m; j++)
+      sum += buf[j];
+    got += (long)m;
+  }
+  s->sum = sum;
+  return NULL;
+}
+
+/* Move items through a fresh queue and return million items per second, or
+   -1 on error or if the consumed items do not add up. pinned reports whether
+   both threads got their CPU. */
+static double run(long items, size_t cap, size_t batch, int pcpu, int ccpu,
+                  int *pinned)
+{
+  struct spscq q;
+  pthread_barrier_t start;
+  struct side p = {.q = &q, .start = &start, .items = items, .batch = batch,
+                   .cpu = pcpu};
+  struct side c = {.q = &q, .start = &start, .items = items, .batch = batch,
+                   .cpu = ccpu};
+
+  if (spscq_init(&q, sizeof(uint64_t), cap, NULL) == -1)
+    return -1;
+  pthread_barrier_init(&start, NULL, 3);
+  if (pthread_create(&p.tid, NULL, produce, &p) ||
+      pthread_create(&c.tid, NULL, consume, &c)) {
+    fprintf(stderr, "pthread_create failed\n");
+    exit(1);
+  }
+  /* Both sides are released only once this thread reaches the barrier, so
+     the clock starts before either of them */
+  uint64_t t0 = bench_ns();
+  pthread_barrier_wait(&start);
+  pthread_join(p.tid, NULL);
+  pthread_join(c.tid, NULL);
+  uint64_t ns = bench_ns() - t0;
+  pthread_barrier_destroy(&start);
+  spscq_fini(&q);
+
+  *pinned = p.pinned && c.pinned;
+  if (c.sum != (uint64_t)items * ((uint64_t)items + 1) / 2)
+    return -1;
+  return (double)items / ((double)ns / 1e3);
+}
+
+int main(int argc, char *argv[])
+{
+  static const size_t batches[] = {1, 16, 64, 256, 1024};
+  long items = argc > 1 ? atol(argv[1]) : 20000000;
+  size_t cap = argc > 2 ? (size_t)atol(argv[2]) : 4096;
+  int pcpu = argc > 3 ? atoi(argv[3]) : 0;
+  int ccpu = argc > 4 ? atoi(argv[4]) : 1;
+  int pinned = 0;
+
+  if (items < 1 || cap < 2 || pcpu < 0 || ccpu < 0) {
+    fprintf(stderr,
+            "usage: %s [items [capacity [producer cpu [consumer cpu]]]]\n",
+            argv[0]);
+    return 1;
+  }
+  printf("%ld items, capacity %zu, producer on cpu %d, consumer on cpu %d\n",
+         items, cap, pcpu % bench_ncpu(), ccpu % bench_ncpu());
+  printf("%8s %14s\n", "batch", "items M/s");
+  for (size_t i = 0; i < sizeof(batches) / sizeof(batches[0]); i++) {
+    double r = run(items, cap, batches[i], pcpu, ccpu, &pinned);
+    if (r < 0) {
+      fprintf(stderr, "spscq lost items\n");
+      return 1;
+    }
+    printf("%8zu %14.2f\n", batches[i], r);
+  }
+  if (!pinned)
+    printf("warning: threads could not be pinned\n");
+  else if (pcpu % bench_ncpu() == ccpu % bench_ncpu())
+    printf("warning: producer and consumer share a CPU\n");
+  return 0;
+}
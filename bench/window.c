@@ -0,0 +1,137 @@
+/* collection - A generic data structure and algorithms library
+ * Copyright (C) 2025 Yixiang Qiu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* Sliding windows of 1K to 1M random 8-byte values: after filling the window,
+   every step pushes a value, evicts the oldest one and queries the window.
+   winmono keeps the minimum and winagg the sum. Every sum is checked against
+   a running total and the last minimum against a scan of the window.
+
+   usage: window [steps [max window]] */
+
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <window.h>
+
+static int cmp_u64(void *a, void *b)
+{
+  uint64_t x = *(uint64_t *)a, y = *(uint64_t *)b;
+  return (x > y) - (x < y);
+}
+
+static void op_sum(void *dst, void *a, void *b)
+{
+  *(uint64_t *)dst = *(uint64_t *)a + *(uint64_t *)b;
+}
+
+/* Return million steps per second, or -1 on error or if the minimum of the
+   final window is wrong */
+static double run_mono(const uint64_t *vals, size_t win, long steps)
+{
+  struct winmono w;
+  uint64_t min = UINT64_MAX;
+
+  if (winmono_init(&w, sizeof(uint64_t), cmp_u64) == -1)
+    return -1;
+  for (size_t i = 0; i < win; i++) {
+    if (winmono_push(&w, (void *)&vals[i]) == -1) {
+      winmono_fini(&w);
+      return -1;
+    }
+  }
+  uint64_t t0 = bench_ns();
+  for (long i = 0; i < steps; i++) {
+    if (winmono_push(&w, (void *)&vals[win + (size_t)i]) == -1) {
+      winmono_fini(&w);
+      return -1;
+    }
+    winmono_evict(&w);
+    winmono_query(&w);
+  }
+  uint64_t ns = bench_ns() - t0;
+  for (size_t i = 0; i < win; i++) {
+    if (vals[(size_t)steps + i] < min)
+      min = vals[(size_t)steps + i];
+  }
+  int ok = *(uint64_t *)winmono_query(&w) == min;
+  winmono_fini(&w);
+  return ok ? (double)steps / ((double)ns / 1e3) : -1;
+}
+
+/* Same for winagg, returns -1 as well if a queried sum is wrong */
+static double run_agg(const uint64_t *vals, size_t win, long steps)
+{
+  struct winagg w;
+  uint64_t total = 0, got;
+  int ok = 1;
+
+  if (winagg_init(&w, sizeof(uint64_t), op_sum) == -1)
+    return -1;
+  for (size_t i = 0; i < win; i++) {
+    total += vals[i];
+    if (winagg_push(&w, (void *)&vals[i]) == -1) {
+      winagg_fini(&w);
+      return -1;
+    }
+  }
+  uint64_t t0 = bench_ns();
+  for (long i = 0; i < steps; i++) {
+    if (winagg_push(&w, (void *)&vals[win + (size_t)i]) == -1) {
+      winagg_fini(&w);
+      return -1;
+    }
+    winagg_evict(&w, NULL);
+    winagg_query(&w, &got);
+    total += vals[win + (size_t)i] - vals[(size_t)i];
+    ok &= got == total;
+  }
+  uint64_t ns = bench_ns() - t0;
+  winagg_fini(&w);
+  return ok ? (double)steps / ((double)ns / 1e3) : -1;
+}
+
+int main(int argc, char *argv[])
+{
+  long steps = argc > 1 ? atol(argv[1]) : 4000000;
+  size_t maxwin = argc > 2 ? (size_t)atol(argv[2]) : (size_t)1 << 20;
+  uint32_t seed = 2463534242u;
+
+  if (steps < 1 || maxwin < 1024) {
+    fprintf(stderr, "usage: %s [steps [max window >= 1024]]\n", argv[0]);
+    return 1;
+  }
+  uint64_t *vals = malloc((maxwin + (size_t)steps) * sizeof(uint64_t));
+  if (!vals)
+    return 1;
+  for (size_t i = 0; i < maxwin + (size_t)steps; i++)
+    vals[i] = bench_rand(&seed);
+
+  printf("%ld steps of push, evict and query\n", steps);
+  printf("%10s %14s %14s\n", "window", "min Msteps/s", "sum Msteps/s");
+  for (size_t win = 1024; win <= maxwin; win *= 4) {
+    double mono = run_mono(vals, win, steps);
+    double agg = run_agg(vals, win, steps);
+    if (mono < 0 || agg < 0) {
+      fprintf(stderr, "window failed\n");
+      free(vals);
+      return 1;
+    }
+    printf("%10zu %14.2f %14.2f\n", win, mono, agg);
+  }
+  free(vals);
+  return 0;
+}
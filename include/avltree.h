@@ -22,10 +22,15 @@
 
 #include <stddef.h>
 
+/* An AVL tree of height h has at least F(h+2) - 1 nodes, so 1.44 log2(n) bounds
+   the height and 96 nodes cover any path in a tree that fits in memory */
+#define AVLTREE_MAXHEIGHT 96
+
 struct avltree_node {
   void *key;
   void *val;
   int height;
+  size_t count; /* Nodes in the subtree rooted here, for rank and select */
   struct avltree_node *left;
   struct avltree_node *right;
 };
@@ -68,4 +73,62 @@ struct avltree_node *avltree_findnode(struct avltree *tree, void *key);
 
 void avltree_clear(struct avltree *tree);
 
+/* Get the node with the smallest or largest key, NULL if the tree is empty */
+struct avltree_node *avltree_first(struct avltree *tree);
+struct avltree_node *avltree_last(struct avltree *tree);
+
+/* Get the first node whose key is not less than (lower bound) or greater than
+   (upper bound) the given key, NULL if there is none */
+struct avltree_node *avltree_lower_bound(struct avltree *tree, void *key);
+struct avltree_node *avltree_upper_bound(struct avltree *tree, void *key);
+
+/* Call cb on every node with lo <= key < hi in order, a NULL bound is open.
+   Stops early when cb returns non-zero. Returns the number of nodes visited. */
+size_t avltree_range(struct avltree *tree, void *lo, void *hi,
+                     int (*cb)(struct avltree_node *, void *), void *arg);
+
+/* Get the node with the k-th smallest key counting from 0, NULL if k is out of
+   range */
+struct avltree_node *avltree_select(struct avltree *tree, size_t k);
+
+/* Get the number of keys less than key, key itself need not be in the tree */
+size_t avltree_rank(struct avltree *tree, void *key);
+
+/* Get the number of keys with lo <= key < hi, a NULL bound is open */
+size_t avltree_count_range(struct avltree *tree, void *lo, void *hi);
+
+/* Build the tree from n keys in strictly increasing order with their values,
+   vals may be NULL. The tree must be empty. Runs in O(n) and leaves the tree
+   perfectly balanced. Returns 0 on success, -1 on error or unsorted keys. */
+int avltree_build_sorted(struct avltree *tree, void **keys, void **vals,
+                         size_t n);
+
+/* Move every entry of other into tree, all keys of one tree must be less than
+   all keys of the other. O(log n). Returns 0 on success, -1 on error or if the
+   key ranges overlap. */
+int avltree_join(struct avltree *tree, struct avltree *other);
+
+/* Move every entry with a key >= key from tree into dest, which must be
+   initialized and empty. O(log n). Returns 0 on success, -1 on error. */
+int avltree_split(struct avltree *tree, void *key, struct avltree *dest);
+
+/* In-order iterator holding the path from the root to the current node, it is
+   invalidated by any insert or remove */
+struct avltree_iter {
+  struct avltree *tree;
+  struct avltree_node *path[AVLTREE_MAXHEIGHT];
+  int depth; /* Nodes on the path, 0 once past either end */
+};
+
+/* Position the iterator on the first node, the last node or the lower bound
+   of key. Returns -1 on error, 0 otherwise even when there is no such node. */
+int avltree_iter_init(struct avltree_iter *iter, struct avltree *tree);
+int avltree_iter_rinit(struct avltree_iter *iter, struct avltree *tree);
+int avltree_iter_seek(struct avltree_iter *iter, struct avltree *tree,
+                      void *key);
+void avltree_iter_inc(struct avltree_iter *iter);
+void avltree_iter_dec(struct avltree_iter *iter);
+/* Get the current node, NULL past either end */
+struct avltree_node *avltree_iter_get(struct avltree_iter *iter);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,99 @@
+/* collection - A generic data structure and algorithms library
+ * Copyright (C) 2025 Yixiang Qiu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef COL_BPTREE_H
+#define COL_BPTREE_H
+
+/* B+tree ordered map. Nodes hold up to BPTREE_ORDER keys so a lookup touches
+   a handful of nodes instead of one per level of a binary tree, and the leaves
+   are linked for ordered scans. */
+
+#include <stddef.h>
+
+#define BPTREE_ORDER 32 /* Maximum keys per node */
+
+struct bptree_node {
+  int leaf;
+  int n;
+  void *keys[BPTREE_ORDER];
+  union {
+    struct bptree_node *child[BPTREE_ORDER + 1]; /* Inner nodes */
+    struct {                                     /* Leaves */
+      void *vals[BPTREE_ORDER];
+      struct bptree_node *prev;
+      struct bptree_node *next;
+    };
+  };
+};
+
+/* A NULL cmp stores integer keys in the key pointer itself, they are compared
+   as intptr_t without calling back, and 0 is a valid key */
+struct bptree_fns {
+  int (*cmp)(void *, void *);
+  void (*destroy_key)(void *);
+  void (*destroy_val)(void *);
+};
+
+struct bptree {
+  struct bptree_node *root;
+  size_t size;
+  struct bptree_fns *fns;
+};
+
+#define bptree_empty(tree) ((tree)->size == 0) /* Check if it is empty */
+#define bptree_size(tree) ((tree)->size)       /* Get the size of the bptree */
+#define bptree_fns(tree) ((tree)->fns)         /* Get the fns of the bptree */
+
+int bptree_init(struct bptree *tree, struct bptree_fns *fns);
+void bptree_fini(struct bptree *tree);
+
+/* Insert a new key-value pair. Returns 0 on success, -1 on error or if the key
+   already exists */
+int bptree_insert(struct bptree *tree, void *key, void *val);
+
+/* Update the value of the given key. Returns 0 on success, -1 on error or if
+   the key does not exist */
+int bptree_update(struct bptree *tree, void *key, void *newval, void **dest);
+
+/* Remove a key-value pair. Returns 0 on success, -1 on error or if the key
+   does not exist */
+int bptree_remove(struct bptree *tree, void *key, void **dest);
+
+void *bptree_find(struct bptree *tree, void *key);
+/* Check if the key exists, for maps whose values may be NULL */
+int bptree_contains(struct bptree *tree, void *key);
+
+void bptree_clear(struct bptree *tree);
+
+/* Position in a leaf, it is invalidated by any insert or remove */
+struct bptree_iter {
+  struct bptree_node *leaf; /* NULL once past either end */
+  int idx;
+};
+
+/* Position the iterator on the first entry, the last entry or the lower bound
+   of key. Returns -1 on error, 0 otherwise even when there is no such entry. */
+int bptree_iter_init(struct bptree_iter *iter, struct bptree *tree);
+int bptree_iter_rinit(struct bptree_iter *iter, struct bptree *tree);
+int bptree_iter_seek(struct bptree_iter *iter, struct bptree *tree,
+                     void *key);
+void bptree_iter_inc(struct bptree_iter *iter);
+void bptree_iter_dec(struct bptree_iter *iter);
+/* Get the current entry, key or val may be NULL. Returns -1 past either end */
+int bptree_iter_get(struct bptree_iter *iter, void **key, void **val);
+
+#endif
@@ -0,0 +1,75 @@
+/* collection - A generic data structure and algorithms library
+ * Copyright (C) 2025 Yixiang Qiu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef COL_BQUEUE_H
+#define COL_BQUEUE_H
+
+/* Blocking FIFO queue for producer/consumer pools, a struct queue guarded by
+   a mutex with condition variables for both directions. Waiters spin briefly
+   on the lock-free size before sleeping and are woken one per element, so a
+   single push never wakes the whole pool. */
+
+#include <pthread.h>
+#include <queue.h>
+#include <stdatomic.h>
+#include <stddef.h>
+
+struct bqueue {
+  struct queue queue;
+  size_t cap;        /* Maximum size, 0 for unbounded */
+  size_t nwaitdeq;   /* Consumers sleeping on notempty */
+  size_t nwaitenq;   /* Producers sleeping on notfull */
+  atomic_size_t sz;  /* Size mirror readable without the lock */
+  atomic_int closed; /* Set once by bqueue_close */
+  pthread_mutex_t lock;
+  pthread_cond_t notempty;
+  pthread_cond_t notfull;
+};
+
+#define bqueue_capacity(bq) ((bq)->cap) /* Get the capacity of the queue */
+
+/* A zero cap makes the queue unbounded, enq then never blocks */
+int bqueue_init(struct bqueue *bq, size_t elesz, size_t cap,
+                void (*destroy)(void *));
+/* Not thread-safe, no thread may still be using or waiting on the queue */
+void bqueue_fini(struct bqueue *bq);
+
+/* Approximate number of elements */
+size_t bqueue_size(struct bqueue *bq);
+
+/* Push a copy of ele, blocking while the queue is full. Returns -1 with errno
+   set to EPIPE if the queue is closed. */
+int bqueue_enq(struct bqueue *bq, void *ele);
+
+/* Pop the oldest element into dest (or destroy it when dest is NULL), blocking
+   while the queue is empty. Returns -1 with errno set to EPIPE once the queue
+   is closed and drained. */
+int bqueue_deq(struct bqueue *bq, void *dest);
+
+/* Same as bqueue_deq but gives up after ms milliseconds on the monotonic
+   clock with errno set to ETIMEDOUT */
+int bqueue_deq_timeout(struct bqueue *bq, void *dest, unsigned long ms);
+
+/* Block until the queue is non-empty, then pop up to n elements into dest.
+   Returns the number popped, 0 once the queue is closed and drained. */
+size_t bqueue_drain_n(struct bqueue *bq, void *dest, size_t n);
+
+/* Refuse further pushes and wake every waiter, consumers may still drain the
+   elements left */
+void bqueue_close(struct bqueue *bq);
+
+#endif
@@ -45,6 +45,7 @@ void deq_fini(struct deque *deq);
 
 void *deq_at(const struct deque *deq, size_t idx);
 int deq_resize(struct deque *deq, size_t newsize);
+int deq_reserve(struct deque *deq, size_t n);
 int deq_shrink(struct deque *deq);
 
 int deq_insert(struct deque *deq, size_t idx, void *ele);
@@ -55,6 +56,15 @@ int deq_pushfront(struct deque *deq, void *ele);
 int deq_popback(struct deque *deq, void *dest);
 int deq_popfront(struct deque *deq, void *dest);
 
+/* Bulk transfer of n elements with at most two memcpy calls, all or nothing */
+int deq_pushback_n(struct deque *deq, void *base, size_t n);
+int deq_popfront_n(struct deque *deq, void *dest, size_t n);
+
+/* Get the elements as up to two contiguous spans, front to back. The second
+   span is NULL with length 0 when the elements do not wrap. */
+int deq_spans(const struct deque *deq, void **a, size_t *alen, void **b,
+              size_t *blen);
+
 void deq_clear(struct deque *deq);
 
 struct deque_iter {
@@ -27,18 +27,87 @@ struct heap;
   vec_empty(&(heap)->vec)                      /* Check if the heap is empty */
 #define heap_size(heap) vec_size(&(heap)->vec) /* Get the size of the heap */
 
+/* Initialize with the default arity: 4-ary for elements of up to 16 bytes, so
+   a node's children share a cache line, binary otherwise */
 int heap_init(struct heap *heap, size_t elesz, int (*cmp)(void *, void *),
               void (*destroy)(void *));
+
+/* Initialize a d-ary heap, arity must be 2, 4 or 8 */
+int heap_init_arity(struct heap *heap, size_t elesz, size_t arity,
+                    int (*cmp)(void *, void *), void (*destroy)(void *));
+/* Initialize a heap from n elements at base with Floyd's O(n) heapify */
+int heap_init_from(struct heap *heap, void *base, size_t n, size_t elesz,
+                   int (*cmp)(void *, void *), void (*destroy)(void *));
 void heap_fini(struct heap *heap);
 
+/* Push a copy of ele, ele must not point into the heap: the element is sifted
+   through a hole and the buffer may be reallocated before ele is read */
 int heap_push(struct heap *heap, void *ele);
 int heap_pop(struct heap *heap, void *dest);
+
+/* Push n elements from base with a single append, then restore the heap
+   either by a full heapify or by sifting up the new elements, whichever is
+   cheaper */
+int heap_push_bulk(struct heap *heap, void *base, size_t n);
+
+/* Pop the top into dest (or destroy it) and push ele with a single sift, ele
+   must not point into the heap. Returns -1 if the heap is empty */
+int heap_replace_top(struct heap *heap, void *ele, void *dest);
 void *heap_peek(struct heap *heap);
+
+/* Bounded push for top-k selection, keeps at most k elements. Once the heap
+   holds k elements, ele replaces the top only if it orders after it, the
+   evicted top is destroyed. As with heap_push, ele must not point into the
+   heap. Returns 0 if ele was stored, 1 if it was rejected
+   and -1 on error. */
+int heap_topk(struct heap *heap, void *ele, size_t k);
 void heap_clear(struct heap *heap);
 
 struct heap {
   struct vector vec;
   int (*cmp)(void *, void *);
+  size_t arity;
 };
 
+/* Addressable heap: every push returns a stable handle that can be used to
+   update or erase the element in O(log n). Positions are tracked in side
+   vectors next to the element buffer of the embedded heap, which must not be
+   modified through the heap_* functions. */
+struct iheap {
+  struct heap heap;
+  struct vector pos;   /* Handle to heap index */
+  struct vector hnd;   /* Heap index to handle */
+  struct vector freeh; /* Released handles, reused first */
+};
+
+#define iheap_empty(ih)                                                        \
+  heap_empty(&(ih)->heap) /* Check if the indexed heap is empty */
+#define iheap_size(ih)                                                         \
+  heap_size(&(ih)->heap) /* Get the size of the indexed heap */
+
+int iheap_init(struct iheap *ih, size_t elesz, int (*cmp)(void *, void *),
+               void (*destroy)(void *));
+void iheap_fini(struct iheap *ih);
+
+/* Push a copy of ele, its handle is stored in handle if not NULL. A handle
+   stays valid until its element is popped or erased. ele must not point into
+   the heap. */
+int iheap_push(struct iheap *ih, void *ele, size_t *handle);
+int iheap_pop(struct iheap *ih, void *dest);
+void *iheap_peek(struct iheap *ih);
+
+/* Get the element of a handle, it may be modified in place as long as
+   iheap_update is called afterwards. Returns NULL for an invalid handle. */
+void *iheap_get(struct iheap *ih, size_t handle);
+
+/* Restore the heap order after the element of handle changed its key, in
+   either direction */
+int iheap_update(struct iheap *ih, size_t handle);
+
+/* Remove the element of handle, copying it to dest or destroying it */
+int iheap_erase(struct iheap *ih, size_t handle, void *dest);
+
+/* Remove all elements, every handle becomes invalid */
+void iheap_clear(struct iheap *ih);
+
 #endif
\ No newline at end of file
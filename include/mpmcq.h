@@ -0,0 +1,62 @@
+/* collection - A generic data structure and algorithms library
+ * Copyright (C) 2025 Yixiang Qiu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef COL_MPMCQ_H
+#define COL_MPMCQ_H
+
+/* Bounded lock-free multi-producer multi-consumer queue. Every slot carries a
+   sequence number telling producers and consumers whose turn it is, so a
+   thread claims a position with a single CAS and never blocks others. */
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <util.h>
+
+struct mpmcq {
+  char *buf;
+  size_t elesz;
+  size_t stride; /* Slot size, sequence number followed by the element */
+  size_t mask;   /* Capacity - 1, the capacity is a power of two */
+  void (*destroy)(void *);
+  _Alignas(COL_CACHELINE) atomic_size_t enq; /* Next position to produce */
+  _Alignas(COL_CACHELINE) atomic_size_t deq; /* Next position to consume */
+  char pad[COL_CACHELINE - sizeof(atomic_size_t)];
+};
+
+#define mpmcq_capacity(q) ((q)->mask + 1) /* Get the capacity of the queue */
+
+/* Capacity is rounded up to a power of two of at least 2 */
+int mpmcq_init(struct mpmcq *q, size_t elesz, size_t cap,
+               void (*destroy)(void *));
+/* Not thread-safe, no other thread may use the queue */
+void mpmcq_fini(struct mpmcq *q);
+
+/* Approximate number of elements, exact only when the queue is quiescent */
+size_t mpmcq_size(struct mpmcq *q);
+
+/* Copy ele into the queue. Returns -1 if the queue is full. */
+int mpmcq_try_enq(struct mpmcq *q, void *ele);
+/* Copy the oldest element to dest (or destroy it when dest is NULL). Returns
+   -1 if the queue is empty. */
+int mpmcq_try_deq(struct mpmcq *q, void *dest);
+
+/* Batch variants claiming up to n consecutive positions with one CAS, return
+   the number of elements moved */
+size_t mpmcq_try_enq_n(struct mpmcq *q, void *base, size_t n);
+size_t mpmcq_try_deq_n(struct mpmcq *q, void *dest, size_t n);
+
+#endif
@@ -0,0 +1,63 @@
+/* collection - A generic data structure and algorithms library
+ * Copyright (C) 2025 Yixiang Qiu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef COL_RADIXHEAP_H
+#define COL_RADIXHEAP_H
+
+/* Radix heap: a monotone min priority queue keyed by unsigned integers, for
+   schedulers whose priorities never go below the last popped key (timestamps).
+   Elements are bucketed by the highest bit in which their key differs from the
+   last popped key, so each element is moved at most once per key bit and a pop
+   costs O(log C) amortized with few comparisons. */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector.h>
+
+#define RADIXHEAP_BUCKETS 65 /* One per differing bit of a 64-bit key, plus 0 */
+
+struct radixheap {
+  struct vector buckets[RADIXHEAP_BUCKETS];
+  uint64_t last; /* Last popped key, the lower bound for pushes */
+  size_t elesz;
+  size_t sz;
+};
+
+#define radixheap_empty(rh)                                                    \
+  ((rh)->sz == 0) /* Check if the radix heap is empty */
+#define radixheap_size(rh) ((rh)->sz) /* Get the size of the radix heap */
+
+int radixheap_init(struct radixheap *rh, size_t elesz, void (*destroy)(void *));
+void radixheap_fini(struct radixheap *rh);
+
+/* Push a copy of ele with the given key. Returns -1 on error or if the key is
+   below the last popped key. */
+int radixheap_push(struct radixheap *rh, uint64_t key, void *ele);
+
+/* Pop the element with the smallest key, the key is stored in key and the
+   element copied to dest (or destroyed) when they are not NULL */
+int radixheap_pop(struct radixheap *rh, uint64_t *key, void *dest);
+
+/* Get the element with the smallest key and store the key in key if not NULL.
+   The returned key becomes the lower bound for pushes. Returns NULL if the
+   heap is empty. */
+void *radixheap_peek(struct radixheap *rh, uint64_t *key);
+
+/* Remove all elements, the last popped key is kept as the lower bound */
+void radixheap_clear(struct radixheap *rh);
+
+#endif
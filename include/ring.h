@@ -0,0 +1,60 @@
+/* collection - A generic data structure and algorithms library
+ * Copyright (C) 2025 Yixiang Qiu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef COL_RING_H
+#define COL_RING_H
+
+/* Fixed-capacity circular buffer on top of the deque layout. The buffer is
+   allocated once, a push on a full ring overwrites the oldest element, so it
+   always holds the most recent cap elements (rolling windows, telemetry). */
+
+#include <deque.h>
+#include <stddef.h>
+
+struct ring {
+  struct deque deq;
+  size_t cap; /* Maximum number of elements */
+};
+
+#define ring_empty(ring)                                                       \
+  deq_empty(&(ring)->deq) /* Check if the ring is empty */
+#define ring_size(ring) deq_size(&(ring)->deq) /* Get the size of the ring */
+#define ring_capacity(ring) ((ring)->cap) /* Get the capacity of the ring */
+#define ring_full(ring)                                                        \
+  (deq_size(&(ring)->deq) == (ring)->cap) /* Check if the ring is full */
+
+int ring_init(struct ring *ring, size_t elesz, size_t cap,
+              void (*destroy)(void *));
+void ring_fini(struct ring *ring);
+
+/* Get the element at idx, 0 is the oldest */
+void *ring_at(const struct ring *ring, size_t idx);
+
+/* Append a copy of ele. On a full ring the oldest element is copied to
+   evicted (or destroyed when evicted is NULL) and 1 is returned, otherwise
+   0. */
+int ring_push(struct ring *ring, void *ele, void *evicted);
+/* Remove the oldest element */
+int ring_pop(struct ring *ring, void *dest);
+
+/* Get the elements as up to two contiguous spans, oldest first */
+int ring_spans(const struct ring *ring, void **a, size_t *alen, void **b,
+               size_t *blen);
+
+void ring_clear(struct ring *ring);
+
+#endif
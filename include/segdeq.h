@@ -0,0 +1,60 @@
+/* collection - A generic data structure and algorithms library
+ * Copyright (C) 2025 Yixiang Qiu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef COL_SEGDEQ_H
+#define COL_SEGDEQ_H
+
+/* Segmented double-ended queue. Elements live in fixed-size blocks reached
+   through a map of block pointers, so growing at either end allocates one
+   block and never moves existing elements: pointers to an element stay valid
+   until that element is popped. */
+
+#include <stddef.h>
+
+struct segdeq {
+  char **map;    /* Block pointers, the used ones are contiguous */
+  size_t mapcap; /* Slots in map */
+  size_t mfirst; /* Map slot of the front block */
+  size_t nblk;   /* Blocks in use */
+  size_t off;    /* Index of the front element in the front block */
+  size_t sz;     /* Number of elements */
+  size_t elesz;  /* Element size */
+  size_t shift;  /* log2 of the elements per block */
+  char *spare;   /* Emptied block kept for reuse, or NULL */
+  void (*destroy)(void *);
+};
+
+#define segdeq_empty(dq) ((dq)->sz == 0) /* Check if the deque is empty */
+#define segdeq_size(dq) ((dq)->sz)       /* Get the size of the deque */
+#define segdeq_front(dq)                                                       \
+  segdeq_at((dq), 0) /* Get the front element of the deque */
+#define segdeq_back(dq)                                                        \
+  segdeq_at((dq), segdeq_size((dq)) - 1) /* Get the back element of the deque */
+
+int segdeq_init(struct segdeq *dq, size_t elesz, void (*destroy)(void *));
+void segdeq_fini(struct segdeq *dq);
+
+void *segdeq_at(const struct segdeq *dq, size_t idx);
+
+int segdeq_pushback(struct segdeq *dq, void *ele);
+int segdeq_pushfront(struct segdeq *dq, void *ele);
+int segdeq_popback(struct segdeq *dq, void *dest);
+int segdeq_popfront(struct segdeq *dq, void *dest);
+
+void segdeq_clear(struct segdeq *dq);
+
+#endif
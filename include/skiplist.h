@@ -0,0 +1,111 @@
+/* collection - A generic data structure and algorithms library
+ * Copyright (C) 2025 Yixiang Qiu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef COL_SKIPLIST_H
+#define COL_SKIPLIST_H
+
+/* Lock-free skip list ordered map for many concurrent readers and writers.
+   Links are changed with CAS only, a removed node is first marked in its next
+   pointers and then unlinked by whichever thread passes it. Unlinked nodes are
+   freed through epoch based reclamation: every operation announces the global
+   epoch it started in, and a node is freed only after the epoch has advanced
+   twice past its unlinking, when no operation can still hold it. */
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <util.h>
+
+#define SKIPLIST_MAXLEVEL 16 /* Levels, with 1/4 promotion covers 4^16 keys */
+#define SKIPLIST_NSLOT 64    /* Threads that can be inside operations at once */
+
+struct skiplist_node {
+  void *key;
+  void *val;
+  struct skiplist_node *retired; /* Limbo list link once unlinked */
+  size_t epoch;                  /* Global epoch when it was retired */
+  atomic_int state;              /* Which of inserter and remover finished */
+  int ownval;                    /* The remover handed val to its caller */
+  int height;
+  _Atomic(uintptr_t) next[]; /* Successors, the low bit marks removal */
+};
+
+struct skiplist_fns {
+  int (*cmp)(void *, void *);
+  void (*destroy_key)(void *);
+  void (*destroy_val)(void *);
+};
+
+/* Epoch announcement of one operation, with the nodes retired while it held
+   the slot */
+struct skiplist_slot {
+  _Alignas(COL_CACHELINE) atomic_size_t state; /* 0 idle, epoch << 1 | 1 */
+  struct skiplist_node *limbo;
+  size_t nlimbo;
+};
+
+struct skiplist {
+  struct skiplist_node *head; /* Sentinel with SKIPLIST_MAXLEVEL levels */
+  struct skiplist_fns *fns;
+  struct skiplist_slot *slots;
+  _Alignas(COL_CACHELINE) atomic_size_t epoch;
+  _Alignas(COL_CACHELINE) atomic_size_t size;
+  char pad[COL_CACHELINE - sizeof(atomic_size_t)];
+};
+
+int skiplist_init(struct skiplist *sl, struct skiplist_fns *fns);
+/* Not thread-safe, no other thread may use the list */
+void skiplist_fini(struct skiplist *sl);
+
+/* Approximate number of entries, exact only when the list is quiescent. Under
+   concurrent inserts it may count keys not yet linked, never wraps below 0 */
+size_t skiplist_size(struct skiplist *sl);
+
+/* Insert a new key-value pair. Returns 0 on success, -1 on error or if the key
+   already exists */
+int skiplist_insert(struct skiplist *sl, void *key, void *val);
+
+/* Remove a key-value pair, the key (and the value when dest is NULL) is
+   destroyed once no thread can reach it. Returns 0 on success, -1 on error or
+   if the key does not exist */
+int skiplist_remove(struct skiplist *sl, void *key, void **dest);
+
+/* The value may be destroyed by a concurrent remove once this returns */
+void *skiplist_find(struct skiplist *sl, void *key);
+int skiplist_contains(struct skiplist *sl, void *key);
+
+/* Forward iterator. It holds an epoch slot from init to fini, so nodes it can
+   reach stay allocated, and sees every entry present for its whole lifetime
+   in order. Reclamation stalls while it is open, keep it short. */
+struct skiplist_iter {
+  struct skiplist *sl;
+  struct skiplist_node *node; /* NULL past the end */
+  size_t slot;
+};
+
+/* Position the iterator on the first entry or the lower bound of key. Returns
+   -1 on error, 0 otherwise even when there is no such entry. */
+int skiplist_iter_init(struct skiplist_iter *iter, struct skiplist *sl);
+int skiplist_iter_seek(struct skiplist_iter *iter, struct skiplist *sl,
+                       void *key);
+void skiplist_iter_inc(struct skiplist_iter *iter);
+/* Get the current entry, key or val may be NULL. Returns -1 past the end */
+int skiplist_iter_get(struct skiplist_iter *iter, void **key, void **val);
+/* Release the epoch slot, required for every initialized iterator */
+void skiplist_iter_fini(struct skiplist_iter *iter);
+
+#endif
@@ -20,9 +20,44 @@
 
 #include <stddef.h>
 
+struct vector;
+
 /* Default sort implementation in collection, based on introsort */
 int sort(void *base, size_t n, size_t sz, int (*cmp)(void *, void *));
 
+/* Partial sort, the k smallest elements end up sorted in [0, k), the rest are
+   left in unspecified order. Runs in O(n + k log k) */
+int sort_partial(void *base, size_t n, size_t k, size_t sz,
+                 int (*cmp)(void *, void *));
+
+/* Selection (nth_element), place the element that would be at index k after
+   sorting there, with no greater element before it and no smaller one after.
+   Introselect, O(n) on average. Returns -1 if k >= n */
+int select_nth(void *base, size_t n, size_t k, size_t sz,
+               int (*cmp)(void *, void *));
+
+/* Parallel sort on up to nthreads threads (pthreads). Each thread sorts a run
+   with sort, the runs are then merged pairwise with every merge split across
+   threads. Needs a temporary buffer of n * sz bytes, small inputs fall back to
+   sort */
+int sort_par(void *base, size_t n, size_t sz, int (*cmp)(void *, void *),
+             size_t nthreads);
+
+/* External merge sort of fixed-size records read from infd until end of file,
+   the sorted records are written to outfd. At most mem bytes are used for
+   record buffers: runs of mem bytes are sorted with sort and spilled to one
+   temporary file, then k-way merged through a heap in as many passes as the
+   fan-in of mem / sz - 1 runs requires */
+int sort_ext(int infd, int outfd, size_t sz, int (*cmp)(void *, void *),
+             size_t mem);
+
+/* Merge k sorted vectors, appending the result to out. Uses a loser tree, so
+   each output element costs about log k comparisons and is copied once. The
+   merge is stable: equal elements keep run order. All vectors must share the
+   same element size */
+int merge_k(struct vector *runs, size_t k, struct vector *out,
+            int (*cmp)(void *, void *));
+
 #ifdef COL_ALL_SORTS
 
 /* Explicitly enable all sorts, these are internal raw sorts without specific
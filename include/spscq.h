@@ -0,0 +1,63 @@
+/* collection - A generic data structure and algorithms library
+ * Copyright (C) 2025 Yixiang Qiu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef COL_SPSCQ_H
+#define COL_SPSCQ_H
+
+/* Bounded wait-free single-producer single-consumer ring buffer. Each side
+   owns one index on its own cache line and keeps a cached copy of the other
+   side's index, so the shared lines are only touched when the cached view
+   says the ring looks full (or empty). */
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <util.h>
+
+struct spscq {
+  char *buf;
+  size_t elesz;
+  size_t mask; /* Capacity - 1, the capacity is a power of two */
+  void (*destroy)(void *);
+  _Alignas(COL_CACHELINE) atomic_size_t head; /* Written by the consumer */
+  size_t tailcache;                           /* Consumer's view of tail */
+  _Alignas(COL_CACHELINE) atomic_size_t tail; /* Written by the producer */
+  size_t headcache;                           /* Producer's view of head */
+  char pad[COL_CACHELINE - sizeof(atomic_size_t) - sizeof(size_t)];
+};
+
+#define spscq_capacity(q) ((q)->mask + 1) /* Get the capacity of the queue */
+
+/* Capacity is rounded up to a power of two */
+int spscq_init(struct spscq *q, size_t elesz, size_t cap,
+               void (*destroy)(void *));
+/* Not thread-safe, neither side may use the queue */
+void spscq_fini(struct spscq *q);
+
+/* Number of elements, exact when called from the producer or consumer */
+size_t spscq_size(struct spscq *q);
+
+/* Producer side. Returns -1 if the queue is full. */
+int spscq_enq(struct spscq *q, void *ele);
+/* Consumer side, dest NULL destroys the element. Returns -1 if empty. */
+int spscq_deq(struct spscq *q, void *dest);
+
+/* Copy up to n elements in or out with at most two memcpy calls and one
+   index publish, return the number of elements moved */
+size_t spscq_enq_n(struct spscq *q, void *base, size_t n);
+size_t spscq_deq_n(struct spscq *q, void *dest, size_t n);
+
+#endif
@@ -19,7 +19,30 @@
 #define COL_UTIL_H
 
 #include <stddef.h>
+#include <string.h>
+
+/* Assumed cache line size, used to keep indices written by different threads
+   on separate lines */
+#define COL_CACHELINE 64
 
 void swap(void *l, void *r, size_t sz);
 
+/* Fixed-size swap kernels, the constant size memcpy calls are lowered to plain
+   register (or vector) moves by the compiler. swap dispatches to them for the
+   common element sizes. */
+#define COL_SWAPFN(n)                                                          \
+  static inline void swap##n(void *l, void *r)                                 \
+  {                                                                            \
+    unsigned char tmp[n];                                                      \
+    memcpy(tmp, l, n);                                                         \
+    memcpy(l, r, n);                                                           \
+    memcpy(r, tmp, n);                                                         \
+  }
+
+COL_SWAPFN(4)
+COL_SWAPFN(8)
+COL_SWAPFN(16)
+COL_SWAPFN(32)
+COL_SWAPFN(64)
+
 #endif
\ No newline at end of file
@@ -44,6 +44,8 @@ void vec_fini(struct vector *vec);
 
 void *vec_at(const struct vector *vec, size_t idx);
 int vec_resize(struct vector *vec, size_t newsz);
+/* Make room for n elements without changing the size, growing geometrically */
+int vec_reserve(struct vector *vec, size_t n);
 int vec_shrink(struct vector *vec);
 
 int vec_pushback(struct vector *vec, void *ele);
@@ -0,0 +1,80 @@
+/* collection - A generic data structure and algorithms library
+ * Copyright (C) 2025 Yixiang Qiu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef COL_WINDOW_H
+#define COL_WINDOW_H
+
+/* Sliding-window aggregates over a stream of fixed-size values, elements are
+   pushed at the new end and evicted from the old end in FIFO order.
+   winmono answers min or max queries with a monotonic deque, winagg folds the
+   window with any associative operation using two-stack aggregation laid out
+   in a single deque. Both cost O(1) amortized per push, evict and query. */
+
+#include <deque.h>
+#include <stddef.h>
+
+struct winmono {
+  struct deque deq; /* Candidates, each an element followed by its sequence */
+  int (*cmp)(void *, void *);
+  size_t elesz;
+  size_t seqoff; /* Offset of the sequence number in a candidate */
+  size_t lo;     /* Sequence number of the oldest element in the window */
+  size_t hi;     /* Sequence number of the next element pushed */
+};
+
+#define winmono_empty(w) ((w)->lo == (w)->hi) /* Check if the window is empty */
+#define winmono_size(w) ((w)->hi - (w)->lo) /* Get the size of the window */
+
+/* The query returns the element ordered first by cmp, the minimum for an
+   ascending comparator and the maximum for a descending one */
+int winmono_init(struct winmono *w, size_t elesz, int (*cmp)(void *, void *));
+void winmono_fini(struct winmono *w);
+int winmono_push(struct winmono *w, void *ele);
+/* Evict the oldest element of the window */
+int winmono_evict(struct winmono *w);
+/* Get the first element of the window by cmp, NULL if the window is empty */
+void *winmono_query(struct winmono *w);
+void winmono_clear(struct winmono *w);
+
+struct winagg {
+  struct deque deq; /* Window values oldest first, each paired with a slot
+                       for the aggregate of the front stack */
+  void (*op)(void *, void *, void *);
+  size_t elesz;
+  size_t aggoff; /* Offset of the aggregate slot in an entry */
+  size_t nfront; /* Oldest entries whose aggregate slot is valid */
+  char *backagg; /* Aggregate of the entries behind the front stack */
+  char *tmp;     /* Scratch value for op */
+};
+
+#define winagg_empty(w)                                                        \
+  deq_empty(&(w)->deq) /* Check if the window is empty */
+#define winagg_size(w) deq_size(&(w)->deq) /* Get the size of the window */
+
+/* op(dst, a, b) stores a combined with b in dst, it must be associative but
+   need not be commutative, dst never aliases a or b */
+int winagg_init(struct winagg *w, size_t elesz,
+                void (*op)(void *, void *, void *));
+void winagg_fini(struct winagg *w);
+int winagg_push(struct winagg *w, void *ele);
+/* Evict the oldest value of the window into dest when not NULL */
+int winagg_evict(struct winagg *w, void *dest);
+/* Store the aggregate of the window, oldest to newest, in dest */
+int winagg_query(struct winagg *w, void *dest);
+void winagg_clear(struct winagg *w);
+
+#endif
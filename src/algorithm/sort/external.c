@@ -0,0 +1,289 @@
+/* collection - A generic data structure and algorithms library
+ * Copyright (C) 2025 Yixiang Qiu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* fileno, which stdio only declares for POSIX */
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <heap.h>
+#include <sort.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <vector.h>
+
+/* Merge fan-in ceiling, wider merges save passes but shrink each run's read
+   buffer and deepen the heap */
+#define MAXFANIN 256
+
+/* A sorted run, the byte range [off, end) of the pass file, read back through
+   its own buffer during a merge */
+struct run {
+  off_t off; /* Next unread byte in the file */
+  off_t end;
+  char *buf;
+  size_t len; /* Valid bytes in buf */
+  size_t pos; /* Read offset in buf */
+};
+
+/* Heap entry for the merge, the comparator travels with the entry since the
+   heap comparator takes no context */
+struct head {
+  char *rec;
+  struct run *run;
+  int (*cmp)(void *, void *);
+};
+
+static int cmphead(void *a, void *b)
+{
+  struct head *x = a, *y = b;
+  return x->cmp(x->rec, y->rec);
+}
+
+/* Read until len bytes or end of file, returns the bytes read or -1 */
+static ssize_t readall(int fd, void *buf, size_t len)
+{
+  size_t done = 0;
+  while (done < len) {
+    ssize_t r = read(fd, (char *)buf + done, len - done);
+    if (r == -1 && errno == EINTR)
+      continue;
+    if (r == -1)
+      return -1;
+    if (!r)
+      break;
+    done += r;
+  }
+  return done;
+}
+
+static int writeall(int fd, const void *buf, size_t len)
+{
+  size_t done = 0;
+  while (done < len) {
+    ssize_t w = write(fd, (const char *)buf + done, len - done);
+    if (w == -1 && errno == EINTR)
+      continue;
+    if (w == -1)
+      return -1;
+    done += w;
+  }
+  return 0;
+}
+
+/* Refill the run buffer from fd, returns the bytes now available or -1 */
+static ssize_t refill(int fd, struct run *run, size_t cap)
+{
+  size_t left = (size_t)(run->end - run->off);
+  size_t want = left < cap ? left : cap;
+  if (lseek(fd, run->off, SEEK_SET) == -1)
+    return -1;
+  ssize_t r = readall(fd, run->buf, want);
+  if (r == -1)
+    return -1;
+  run->off += r;
+  run->len = r;
+  run->pos = 0;
+  return r;
+}
+
+/* Sort runs of up to mem bytes and append them all to the single file fp, a
+   lone run goes straight to outfd */
+static int spill(int infd, int outfd, size_t sz, int (*cmp)(void *, void *),
+                 size_t mem, FILE *fp, struct vector *runs)
+{
+  size_t cap = mem / sz * sz;
+  char *buf = malloc(cap);
+  off_t off = 0;
+  if (!buf) {
+    errno = ENOMEM;
+    return -1;
+  }
+
+  while (1) {
+    ssize_t r = readall(infd, buf, cap);
+    if (r == -1 || r % sz) {
+      if (r != -1)
+        errno = EINVAL; /* Trailing partial record */
+      goto fail;
+    }
+    if (!r)
+      break;
+    if (sort(buf, r / sz, sz, cmp) == -1)
+      goto fail;
+    if ((size_t)r < cap && vec_empty(runs)) {
+      /* Everything fits in memory, no temporary file needed */
+      if (writeall(outfd, buf, r) == -1)
+        goto fail;
+      break;
+    }
+
+    struct run run = {.off = off, .end = off + r};
+    if (writeall(fileno(fp), buf, r) == -1 || vec_pushback(runs, &run) == -1)
+      goto fail;
+    off += r;
+    if ((size_t)r < cap)
+      break;
+  }
+  free(buf);
+  return 0;
+
+fail:
+  free(buf);
+  return -1;
+}
+
+/* K-way merge of k runs read from infd, appending to outfd through a heap of
+   run heads. The k input buffers and the output buffer share mem. */
+static int merge(int infd, struct run *runs, size_t k, int outfd, size_t sz,
+                 int (*cmp)(void *, void *), size_t mem)
+{
+  size_t chunk = mem / (k + 1) / sz * sz;
+  char *bufs = malloc((k + 1) * chunk);
+  if (!bufs) {
+    errno = ENOMEM;
+    return -1;
+  }
+  char *out = bufs + k * chunk;
+  size_t outlen = 0;
+
+  struct heap h;
+  if (heap_init(&h, sizeof(struct head), cmphead, NULL) == -1)
+    goto fail;
+
+  for (size_t i = 0; i < k; i++) {
+    struct run *run = &runs[i];
+    run->buf = bufs + i * chunk;
+    if (refill(infd, run, chunk) <= 0)
+      goto fail_heap;
+    struct head head = {run->buf, run, cmp};
+    if (heap_push(&h, &head) == -1)
+      goto fail_heap;
+  }
+
+  while (!heap_empty(&h)) {
+    struct head *top = heap_peek(&h);
+    struct run *run = top->run;
+    memcpy(out + outlen, top->rec, sz);
+    outlen += sz;
+    if (outlen == chunk) {
+      if (writeall(outfd, out, outlen) == -1)
+        goto fail_heap;
+      outlen = 0;
+    }
+
+    run->pos += sz;
+    if (run->pos == run->len) {
+      ssize_t r = refill(infd, run, chunk);
+      if (r == -1)
+        goto fail_heap;
+      if (!r) {
+        heap_pop(&h, NULL);
+        continue;
+      }
+    }
+    /* Replace the head with the next record of the same run */
+    struct head next = {run->buf + run->pos, run, cmp};
+    heap_pop(&h, NULL);
+    if (heap_push(&h, &next) == -1)
+      goto fail_heap;
+  }
+  if (outlen && writeall(outfd, out, outlen) == -1)
+    goto fail_heap;
+
+  heap_fini(&h);
+  free(bufs);
+  return 0;
+
+fail_heap:
+  heap_fini(&h);
+fail:
+  free(bufs);
+  return -1;
+}
+
+/* Merge groups of up to fanin runs from *fp into a fresh file until one merge
+   can produce the output, each finished pass file is closed */
+static int mergeall(FILE **fp, struct vector *runs, int outfd, size_t sz,
+                    int (*cmp)(void *, void *), size_t mem)
+{
+  size_t fanin = mem / sz - 1;
+  if (fanin > MAXFANIN)
+    fanin = MAXFANIN;
+
+  while (vec_size(runs) > fanin) {
+    struct vector merged;
+    FILE *next = tmpfile();
+    if (!next)
+      return -1;
+    if (vec_init(&merged, sizeof(struct run), NULL) == -1) {
+      fclose(next);
+      return -1;
+    }
+    size_t n = vec_size(runs);
+    for (size_t i = 0; i < n; i += fanin) {
+      size_t k = n - i < fanin ? n - i : fanin;
+      struct run run = {.off = lseek(fileno(next), 0, SEEK_CUR)};
+      if (run.off == -1 ||
+          merge(fileno(*fp), vec_at(runs, i), k, fileno(next), sz, cmp,
+                mem) == -1 ||
+          (run.end = lseek(fileno(next), 0, SEEK_CUR)) == -1 ||
+          vec_pushback(&merged, &run) == -1) {
+        vec_fini(&merged);
+        fclose(next);
+        return -1;
+      }
+    }
+    fclose(*fp);
+    *fp = next;
+    vec_fini(runs);
+    *runs = merged;
+  }
+  return merge(fileno(*fp), vec_at(runs, 0), vec_size(runs), outfd, sz, cmp,
+               mem);
+}
+
+int sort_ext(int infd, int outfd, size_t sz, int (*cmp)(void *, void *),
+             size_t mem)
+{
+  if (infd < 0 || outfd < 0 || !sz || !cmp)
+    return -1;
+  /* Merging needs two input buffers and one output buffer of a record each */
+  if (mem / sz < 3) {
+    errno = EINVAL;
+    return -1;
+  }
+
+  struct vector runs;
+  FILE *fp = tmpfile();
+  if (!fp)
+    return -1;
+  if (vec_init(&runs, sizeof(struct run), NULL) == -1) {
+    fclose(fp);
+    return -1;
+  }
+
+  int ret = spill(infd, outfd, sz, cmp, mem, fp, &runs);
+  if (!ret && !vec_empty(&runs))
+    ret = mergeall(&fp, &runs, outfd, sz, cmp, mem);
+  vec_fini(&runs);
+  fclose(fp);
+  return ret;
+}
@@ -15,34 +15,74 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
-#include <heap.h>
 #include <stddef.h>
+#include <string.h>
+#include <util.h>
 
 #define GET(base, idx, sz) ((void *)((char *)(base) + (idx) * (sz)))
+#define PARENT(idx) (((idx) - 1) / 2)
+#define LEFT(idx) (2 * (idx) + 1)
+#define RIGHT(idx) (2 * (idx) + 2)
+#define THRESHOLD 256
+
+/* Bottom-up sift of the element at i in the max-heap [0, n): follow the larger
+   children down to a leaf, climb back to the first slot not smaller than the
+   element, then rotate that path up by one level. With tmp the rotation moves
+   a hole (one copy per level), without it falls back to swaps. */
+static void siftdown(void *base, size_t i, size_t n, size_t sz,
+                     int (*cmp)(void *, void *), char *tmp)
+{
+  size_t j = i;
+  while (RIGHT(j) < n)
+    j = cmp(GET(base, RIGHT(j), sz), GET(base, LEFT(j), sz)) > 0 ? RIGHT(j)
+                                                                 : LEFT(j);
+  if (LEFT(j) < n)
+    j = LEFT(j);
+  while (j > i && cmp(GET(base, i, sz), GET(base, j, sz)) > 0)
+    j = PARENT(j);
+  if (j == i)
+    return;
+
+  size_t h = 0;
+  for (size_t k = j; k > i; k = PARENT(k))
+    h++;
+
+  /* Ancestors of j are (j + 1) >> t - 1 in 0-based heap order */
+  size_t prev = i;
+  if (tmp) {
+    memcpy(tmp, GET(base, i, sz), sz);
+    while (h--) {
+      size_t node = ((j + 1) >> h) - 1;
+      memcpy(GET(base, prev, sz), GET(base, node, sz), sz);
+      prev = node;
+    }
+    memcpy(GET(base, j, sz), tmp, sz);
+  } else {
+    while (h--) {
+      size_t node = ((j + 1) >> h) - 1;
+      swap(GET(base, prev, sz), GET(base, node, sz), sz);
+      prev = node;
+    }
+  }
+}
 
 int sortheap(void *base, size_t n, size_t sz, int (*cmp)(void *, void *))
 {
   if (!base || !sz || !cmp)
     return -1;
+  if (n <= 1)
+    return 0;
 
-  struct heap h;
-  if (heap_init(&h, sz, cmp, NULL) == -1)
-    return -1;
+  char stack[THRESHOLD];
+  char *tmp = sz <= THRESHOLD ? stack : NULL;
 
-  for (size_t i = 0; i < n; i++) {
-    if (heap_push(&h, GET(base, i, sz)) == -1) {
-      heap_fini(&h);
-      return -1;
-    }
-  }
+  /* Floyd heapify */
+  for (size_t i = n / 2; i-- > 0;)
+    siftdown(base, i, n, sz, cmp, tmp);
 
-  for (size_t i = 0; i < n; i++) {
-    if (heap_pop(&h, GET(base, i, sz)) == -1) {
-      heap_fini(&h);
-      return -1;
-    }
+  for (size_t end = n - 1; end > 0; end--) {
+    swap(GET(base, 0, sz), GET(base, end, sz), sz);
+    siftdown(base, 0, end, sz, cmp, tmp);
   }
-
-  heap_fini(&h);
   return 0;
-}
\ No newline at end of file
+}
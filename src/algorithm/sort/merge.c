@@ -0,0 +1,127 @@
+/* collection - A generic data structure and algorithms library
+ * Copyright (C) 2025 Yixiang Qiu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <errno.h>
+#include <sort.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector.h>
+
+#define GET(base, idx, sz) ((void *)((char *)(base) + (idx) * (sz)))
+
+/* Loser tree over k runs: node 0 holds the overall winner, nodes [1, k) hold
+   the loser of the match played there, leaves k + i stand for run i */
+struct ltree {
+  struct vector *runs;
+  size_t *node;
+  size_t *pos; /* Cursor into each run */
+  size_t k;
+  int (*cmp)(void *, void *);
+};
+
+/* Whether run i's head goes before run j's head, exhausted runs lose and ties
+   go to the lower run so the merge is stable */
+static inline int beats(struct ltree *t, size_t i, size_t j)
+{
+  if (t->pos[i] == vec_size(&t->runs[i]))
+    return 0;
+  if (t->pos[j] == vec_size(&t->runs[j]))
+    return 1;
+  int c = t->cmp(GET(vec_raw(&t->runs[i]), t->pos[i], t->runs[i].elesz),
+                 GET(vec_raw(&t->runs[j]), t->pos[j], t->runs[j].elesz));
+  return c < 0 || (c == 0 && i < j);
+}
+
+/* Play the initial tournament bottom-up, win is scratch space of 2k */
+static void build(struct ltree *t, size_t *win)
+{
+  for (size_t i = 0; i < t->k; i++)
+    win[t->k + i] = i;
+  for (size_t n = t->k - 1; n >= 1; n--) {
+    size_t a = win[2 * n], b = win[2 * n + 1];
+    if (beats(t, a, b)) {
+      win[n] = a;
+      t->node[n] = b;
+    } else {
+      win[n] = b;
+      t->node[n] = a;
+    }
+  }
+  t->node[0] = win[1];
+}
+
+/* Replay the matches on the path from run w's leaf to the root */
+static inline void replay(struct ltree *t, size_t w)
+{
+  for (size_t n = (w + t->k) / 2; n >= 1; n /= 2) {
+    if (beats(t, t->node[n], w)) {
+      size_t l = t->node[n];
+      t->node[n] = w;
+      w = l;
+    }
+  }
+  t->node[0] = w;
+}
+
+int merge_k(struct vector *runs, size_t k, struct vector *out,
+            int (*cmp)(void *, void *))
+{
+  if (!runs || !out || !cmp)
+    return -1;
+
+  size_t sz = out->elesz, total = 0;
+  for (size_t i = 0; i < k; i++) {
+    if (runs[i].elesz != sz || &runs[i] == out)
+      return -1;
+    total += vec_size(&runs[i]);
+  }
+  if (!total)
+    return 0;
+
+  size_t base = vec_size(out);
+  if (vec_resize(out, base + total) == -1)
+    return -1;
+  char *dst = GET(vec_raw(out), base, sz);
+
+  if (k == 1) {
+    memcpy(dst, vec_raw(&runs[0]), total * sz);
+    return 0;
+  }
+
+  size_t *mem = malloc(4 * k * sizeof(size_t));
+  if (!mem) {
+    out->sz = base; /* Drop the uninitialized tail without destroying it */
+    errno = ENOMEM;
+    return -1;
+  }
+  struct ltree t = {runs, mem, mem + k, k, cmp};
+  memset(t.pos, 0, k * sizeof(size_t));
+  build(&t, mem + 2 * k);
+
+  for (size_t i = 0; i < total; i++) {
+    size_t w = t.node[0];
+    memcpy(dst, GET(vec_raw(&runs[w]), t.pos[w], sz), sz);
+    dst += sz;
+    t.pos[w]++;
+    replay(&t, w);
+  }
+
+  free(mem);
+  return 0;
+}
@@ -0,0 +1,204 @@
+/* collection - A generic data structure and algorithms library
+ * Copyright (C) 2025 Yixiang Qiu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <sort.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define GET(base, idx, sz) ((void *)((char *)(base) + (idx) * (sz)))
+#define THRESHOLD 8192 /* Minimum elements per thread worth splitting for */
+#define MAXTHREADS 256
+
+/* A unit of work for one thread: either sort a[0, alen) in place, or merge
+   a[0, alen) and b[0, blen) into dst */
+struct job {
+  char *a;
+  char *b;
+  char *dst;
+  size_t alen;
+  size_t blen;
+  size_t sz;
+  int (*cmp)(void *, void *);
+  int ret;
+};
+
+/* Number of elements taken from a among the first k merged elements, so that
+   merge(a[0, i), b[0, k - i)) is a prefix of the stable merge */
+static size_t corank(size_t k, char *a, size_t alen, char *b, size_t blen,
+                     size_t sz, int (*cmp)(void *, void *))
+{
+  size_t lo = k > blen ? k - blen : 0;
+  size_t hi = k < alen ? k : alen;
+  while (lo < hi) {
+    size_t i = lo + (hi - lo) / 2;
+    /* a[i] belongs in the prefix if it does not order after b[k - i - 1] */
+    if (cmp(GET(a, i, sz), GET(b, k - i - 1, sz)) <= 0)
+      lo = i + 1;
+    else
+      hi = i;
+  }
+  return lo;
+}
+
+static void merge(struct job *job)
+{
+  size_t sz = job->sz;
+  char *a = job->a, *aend = a + job->alen * sz;
+  char *b = job->b, *bend = b + job->blen * sz;
+  char *dst = job->dst;
+  while (a < aend && b < bend) {
+    if (job->cmp(b, a) < 0) {
+      memcpy(dst, b, sz);
+      b += sz;
+    } else {
+      memcpy(dst, a, sz);
+      a += sz;
+    }
+    dst += sz;
+  }
+  if (a < aend)
+    memcpy(dst, a, aend - a);
+  if (b < bend)
+    memcpy(dst, b, bend - b);
+}
+
+static void *runsort(void *arg)
+{
+  struct job *job = arg;
+  job->ret = sort(job->a, job->alen, job->sz, job->cmp);
+  return NULL;
+}
+
+static void *runmerge(void *arg)
+{
+  merge(arg);
+  return NULL;
+}
+
+/* Run the jobs on their own threads, the last one on the caller. A job whose
+   thread can not be created also runs on the caller. */
+static void runall(struct job *jobs, size_t n, void *(*fn)(void *))
+{
+  pthread_t tids[MAXTHREADS];
+  int started[MAXTHREADS];
+  for (size_t i = 0; i + 1 < n; i++) {
+    started[i] = !pthread_create(&tids[i], NULL, fn, &jobs[i]);
+    if (!started[i])
+      fn(&jobs[i]);
+  }
+  fn(&jobs[n - 1]);
+  for (size_t i = 0; i + 1 < n; i++) {
+    if (started[i])
+      pthread_join(tids[i], NULL);
+  }
+}
+
+int sort_par(void *base, size_t n, size_t sz, int (*cmp)(void *, void *),
+             size_t nthreads)
+{
+  if (!base || !sz || !cmp)
+    return -1;
+  if (nthreads > MAXTHREADS)
+    nthreads = MAXTHREADS;
+  if (nthreads > n / THRESHOLD)
+    nthreads = n / THRESHOLD;
+  if (nthreads <= 1)
+    return sort(base, n, sz, cmp);
+
+  if (n > SIZE_MAX / sz) {
+    errno = ERANGE;
+    return -1;
+  }
+  char *tmp = malloc(n * sz);
+  if (!tmp) {
+    errno = ENOMEM;
+    return -1;
+  }
+
+  /* Sort one run per thread */
+  struct job jobs[MAXTHREADS];
+  size_t bounds[MAXTHREADS + 1];
+  size_t runs = nthreads;
+  for (size_t i = 0; i <= runs; i++)
+    bounds[i] = n / runs * i + (i < n % runs ? i : n % runs);
+  for (size_t i = 0; i < runs; i++) {
+    jobs[i] = (struct job){.a = GET(base, bounds[i], sz),
+                           .alen = bounds[i + 1] - bounds[i],
+                           .sz = sz,
+                           .cmp = cmp};
+  }
+  runall(jobs, runs, runsort);
+  for (size_t i = 0; i < runs; i++) {
+    if (jobs[i].ret) {
+      free(tmp);
+      return -1;
+    }
+  }
+
+  /* Merge runs pairwise each round. Every pair gets a share of the threads and
+     is cut into output segments at co-ranks, so all threads stay busy even in
+     the last rounds. */
+  char *src = base, *dst = tmp;
+  while (runs > 1) {
+    size_t pairs = runs / 2;
+    size_t per = nthreads / pairs ? nthreads / pairs : 1;
+    size_t njobs = 0;
+    for (size_t p = 0; p < pairs; p++) {
+      size_t lo = bounds[2 * p], mid = bounds[2 * p + 1];
+      size_t hi = bounds[2 * p + 2];
+      char *a = GET(src, lo, sz), *b = GET(src, mid, sz);
+      size_t alen = mid - lo, blen = hi - mid, total = hi - lo;
+      size_t prevk = 0, previ = 0;
+      for (size_t t = 1; t <= per; t++) {
+        size_t k = total / per * t + (t == per ? total % per : 0);
+        size_t i = t == per ? alen : corank(k, a, alen, b, blen, sz, cmp);
+        jobs[njobs++] = (struct job){.a = GET(a, previ, sz),
+                                     .alen = i - previ,
+                                     .b = GET(b, prevk - previ, sz),
+                                     .blen = (k - i) - (prevk - previ),
+                                     .dst = GET(dst, lo + prevk, sz),
+                                     .sz = sz,
+                                     .cmp = cmp};
+        prevk = k, previ = i;
+      }
+    }
+    /* An odd run out is carried over unmerged */
+    if (runs % 2) {
+      size_t lo = bounds[runs - 1], hi = bounds[runs];
+      memcpy(GET(dst, lo, sz), GET(src, lo, sz), (hi - lo) * sz);
+    }
+    runall(jobs, njobs, runmerge);
+
+    for (size_t i = 0; i <= pairs; i++)
+      bounds[i] = bounds[2 * i];
+    runs = pairs + runs % 2;
+    bounds[runs] = n;
+
+    char *t = src;
+    src = dst;
+    dst = t;
+  }
+
+  if (src != base)
+    memcpy(base, src, n * sz);
+  free(tmp);
+  return 0;
+}
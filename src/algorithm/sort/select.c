@@ -0,0 +1,96 @@
+/* collection - A generic data structure and algorithms library
+ * Copyright (C) 2025 Yixiang Qiu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define COL_ALL_SORTS
+#include <math.h>
+#include <sort.h>
+#include <stddef.h>
+#include <util.h>
+
+#define GET(base, idx, sz) ((void *)((char *)(base) + (idx) * (sz)))
+#define THRESHOLD 16
+
+/* Median of three partition of n > 3 elements, returns the final pivot index */
+static size_t partition(void *base, size_t n, size_t sz,
+                        int (*cmp)(void *, void *))
+{
+  size_t min = 0, mid = n / 2, max = n - 1;
+  if (cmp(GET(base, min, sz), GET(base, mid, sz)) > 0)
+    swap(GET(base, min, sz), GET(base, mid, sz), sz);
+  if (cmp(GET(base, min, sz), GET(base, max, sz)) > 0)
+    swap(GET(base, min, sz), GET(base, max, sz), sz);
+  if (cmp(GET(base, mid, sz), GET(base, max, sz)) > 0)
+    swap(GET(base, mid, sz), GET(base, max, sz), sz);
+
+  size_t pivot = max - 1;
+  swap(GET(base, mid, sz), GET(base, pivot, sz), sz);
+
+  size_t l = 1, r = n - 3;
+  while (l < r) {
+    while (l < r && cmp(GET(base, l, sz), GET(base, pivot, sz)) < 0)
+      l++;
+    while (l < r && cmp(GET(base, r, sz), GET(base, pivot, sz)) > 0)
+      r--;
+    if (l < r) {
+      swap(GET(base, l, sz), GET(base, r, sz), sz);
+      l++, r--;
+    }
+  }
+  size_t pos = l;
+  if (cmp(GET(base, pos, sz), GET(base, pivot, sz)) <= 0)
+    pos++;
+  swap(GET(base, pos, sz), GET(base, pivot, sz), sz);
+  return pos;
+}
+
+int select_nth(void *base, size_t n, size_t k, size_t sz,
+               int (*cmp)(void *, void *))
+{
+  if (!base || !sz || !cmp || k >= n)
+    return -1;
+
+  /* Introselect: quickselect on the side holding k, fall back to heap sort of
+     the remaining range once the depth budget is spent */
+  int depth = 2 * (int)log2(n);
+  size_t lo = 0, hi = n;
+  while (hi - lo > THRESHOLD) {
+    if (!depth--)
+      return sortheap(GET(base, lo, sz), hi - lo, sz, cmp);
+    size_t pos = lo + partition(GET(base, lo, sz), hi - lo, sz, cmp);
+    if (k == pos)
+      return 0;
+    if (k < pos)
+      hi = pos;
+    else
+      lo = pos + 1;
+  }
+  return sortins(GET(base, lo, sz), hi - lo, sz, cmp);
+}
+
+int sort_partial(void *base, size_t n, size_t k, size_t sz,
+                 int (*cmp)(void *, void *))
+{
+  if (!base || !sz || !cmp)
+    return -1;
+  if (k >= n)
+    return sort(base, n, sz, cmp);
+  if (!k)
+    return 0;
+  if (select_nth(base, n, k - 1, sz, cmp) == -1)
+    return -1;
+  return sort(base, k - 1, sz, cmp);
+}
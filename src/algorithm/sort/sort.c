@@ -19,32 +19,85 @@
 #include <math.h>
 #include <sort.h>
 #include <stddef.h>
+#include <string.h>
 #include <util.h>
 
 #define GET(base, idx, sz) ((void *)((char *)(base) + (idx) * (sz)))
 #define THRESHOLD 16
+#define FIXEDMAX 64 /* Largest element size with a specialized kernel */
 
-static int sortrec(void *base, size_t n, size_t sz, int (*cmp)(void *, void *),
-                   int depth)
+#define INLINE static inline __attribute__((always_inline))
+
+typedef int (*sortrecfn)(void *, size_t, size_t, int (*)(void *, void *),
+                         int);
+
+/* Swap with the size known at compile time in the specialized paths, the
+   switch folds away and the kernel is inlined */
+INLINE void exch(void *l, void *r, size_t sz)
+{
+  switch (sz) {
+  case 4:
+    swap4(l, r);
+    return;
+  case 8:
+    swap8(l, r);
+    return;
+  case 16:
+    swap16(l, r);
+    return;
+  case 32:
+    swap32(l, r);
+    return;
+  case 64:
+    swap64(l, r);
+    return;
+  default:
+    swap(l, r, sz);
+  }
+}
+
+/* Insertion sort for the fixed-size paths, the key lives on the stack */
+INLINE void insertion(void *base, size_t n, size_t sz,
+                      int (*cmp)(void *, void *))
+{
+  char buf[FIXEDMAX];
+  for (size_t cur = 1; cur < n; cur++) {
+    memcpy(buf, GET(base, cur, sz), sz);
+    size_t pos = cur;
+    while (pos && cmp(GET(base, pos - 1, sz), buf) > 0) {
+      memcpy(GET(base, pos, sz), GET(base, pos - 1, sz), sz);
+      pos--;
+    }
+    memcpy(GET(base, pos, sz), buf, sz);
+  }
+}
+
+/* One introsort step, self is the specialized variant to recurse into */
+INLINE int introsort(void *base, size_t n, size_t sz,
+                     int (*cmp)(void *, void *), int depth, sortrecfn self)
 {
-  if (n <= THRESHOLD)
-    return sortins(base, n, sz, cmp);
+  if (n <= THRESHOLD) {
+    if (sz > FIXEDMAX)
+      return sortins(base, n, sz, cmp);
+    insertion(base, n, sz, cmp);
+    return 0;
+  }
   if (!depth)
     return sortheap(base, n, sz, cmp);
 
   size_t min = 0, mid = n / 2, max = n - 1;
   if (cmp(GET(base, min, sz), GET(base, mid, sz)) > 0)
-    swap(GET(base, min, sz), GET(base, mid, sz), sz);
+    exch(GET(base, min, sz), GET(base, mid, sz), sz);
   if (cmp(GET(base, min, sz), GET(base, max, sz)) > 0)
-    swap(GET(base, min, sz), GET(base, max, sz), sz);
+    exch(GET(base, min, sz), GET(base, max, sz), sz);
   if (cmp(GET(base, mid, sz), GET(base, max, sz)) > 0)
-    swap(GET(base, mid, sz), GET(base, max, sz), sz);
+    exch(GET(base, mid, sz), GET(base, max, sz), sz);
 
   if (n <= 3)
     return 0;
 
   size_t pivot = max - 1;
-  swap(GET(base, mid, sz), GET(base, pivot, sz), sz);
+  exch(GET(base, mid, sz), GET(base, pivot, sz), sz);
 
   size_t l = 1, r = n - 3;
   while (l < r) {
@@ -53,17 +106,38 @@ static int sortrec(void *base, size_t n, size_t sz, int (*cmp)(void *, void *),
     while (l < r && cmp(GET(base, r, sz), GET(base, pivot, sz)) > 0)
       r--;
     if (l < r) {
-      swap(GET(base, l, sz), GET(base, r, sz), sz);
+      exch(GET(base, l, sz), GET(base, r, sz), sz);
       l++, r--;
     }
   }
   size_t pos = l;
   if (cmp(GET(base, pos, sz), GET(base, pivot, sz)) <= 0)
     pos++;
-  swap(GET(base, pos, sz), GET(base, pivot, sz), sz);
+  exch(GET(base, pos, sz), GET(base, pivot, sz), sz);
+
+  return self(base, pos, sz, cmp, depth - 1) ||
+         self(GET(base, pos + 1, sz), n - pos - 1, sz, cmp, depth - 1);
+}
+
+/* Generate an introsort variant for a fixed element size */
+#define SORTREC(n)                                                             \
+  static int sortrec##n(void *base, size_t cnt, size_t sz,                     \
+                        int (*cmp)(void *, void *), int depth)                 \
+  {                                                                            \
+    (void)sz;                                                                  \
+    return introsort(base, cnt, n, cmp, depth, sortrec##n);                    \
+  }
+
+SORTREC(4)
+SORTREC(8)
+SORTREC(16)
+SORTREC(32)
+SORTREC(64)
 
-  return sortrec(base, pos, sz, cmp, depth - 1) ||
-         sortrec(GET(base, pos + 1, sz), n - pos - 1, sz, cmp, depth - 1);
+static int sortrec(void *base, size_t n, size_t sz, int (*cmp)(void *, void *),
+                   int depth)
+{
+  return introsort(base, n, sz, cmp, depth, sortrec);
 }
 
 int sort(void *base, size_t n, size_t sz, int (*cmp)(void *, void *))
@@ -73,5 +147,18 @@ int sort(void *base, size_t n, size_t sz, int (*cmp)(void *, void *))
   if (n <= 1)
     return 0;
   int depth = 2 * (int)log2(n);
-  return sortrec(base, n, sz, cmp, depth);
+  switch (sz) {
+  case 4:
+    return sortrec4(base, n, sz, cmp, depth);
+  case 8:
+    return sortrec8(base, n, sz, cmp, depth);
+  case 16:
+    return sortrec16(base, n, sz, cmp, depth);
+  case 32:
+    return sortrec32(base, n, sz, cmp, depth);
+  case 64:
+    return sortrec64(base, n, sz, cmp, depth);
+  default:
+    return sortrec(base, n, sz, cmp, depth);
+  }
 }
\ No newline at end of file
@@ -21,17 +21,35 @@
 
 void swap(void *l, void *r, size_t sz)
 {
-  uint64_t u64;
-  size_t i = 0;
-  for (; i + 8 <= sz; i += 8) {
-    memcpy(&u64, l + i, 8);
-    memcpy(l + i, r + i, 8);
-    memcpy(r + i, &u64, 8);
+  switch (sz) {
+  case 4:
+    swap4(l, r);
+    return;
+  case 8:
+    swap8(l, r);
+    return;
+  case 16:
+    swap16(l, r);
+    return;
+  case 32:
+    swap32(l, r);
+    return;
+  case 64:
+    swap64(l, r);
+    return;
   }
+
+  /* Large records go through 32-byte blocks, which become vector moves */
+  char *lp = l, *rp = r;
+  size_t i = 0;
+  for (; i + 32 <= sz; i += 32)
+    swap32(lp + i, rp + i);
+  for (; i + 8 <= sz; i += 8)
+    swap8(lp + i, rp + i);
   uint8_t u8;
   for (; i < sz; i++) {
-    memcpy(&u8, l + i, 1);
-    memcpy(l + i, r + i, 1);
-    memcpy(r + i, &u8, 1);
+    u8 = lp[i];
+    lp[i] = rp[i];
+    rp[i] = u8;
   }
-}
\ No newline at end of file
+}
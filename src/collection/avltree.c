@@ -29,8 +29,10 @@ static struct avltree_node *create_node(void *key, void *val);
 static void destroy_node(struct avltree_node *node, struct avltree_fns *fns,
                          void **dest, int unlink);
 
-/* Recursively clear the tree */
-static void clear(struct avltree_node *node, struct avltree_fns *fns);
+/* Clear the tree without recursion, left children are rotated up so the
+   nodes are freed along a right spine. Unlink as in destroy_node. */
+static void clear(struct avltree_node *node, struct avltree_fns *fns,
+                  int unlink);
 
 static struct avltree_node *rotate_left(struct avltree_node *node);
 static struct avltree_node *rotate_right(struct avltree_node *node);
@@ -38,18 +40,28 @@ static struct avltree_node *rotate_right(struct avltree_node *node);
 /* Rebalance the tree */
 static struct avltree_node *rebalance(struct avltree_node *node);
 
-/* Recursively insert a node into the tree, return the new root node after
-   insertion. If the node is inserted, set insf to 1. */
-static struct avltree_node *insert_node(struct avltree_node *node, void *key,
-                                        void *val, struct avltree_fns *fns,
-                                        int *insf);
+/* Descend towards key filling the iterator path, then cut the path back to the
+   last node whose key is >= key */
+static void seek(struct avltree_iter *iter, void *key);
 
-/* Recursively remove a node from the tree, return the new root node after
-   removal. If the node is removed, set remf to 1. If unlink is set, free node
-   only without destroying key and value. */
-static struct avltree_node *remove_node(struct avltree_node *node, void *key,
-                                        void **dest, struct avltree_fns *fns,
-                                        int *remf, int unlink);
+/* Rebalance the subtrees hanging from the top n links of path, deepest
+   first. Once a subtree keeps its old height only the counts above it are
+   refreshed. */
+static void retrace(struct avltree_node **path[], int n);
+
+/* Build a balanced subtree from n sorted keys, allocating nodes in key order.
+   Returns NULL for n == 0 or when allocation fails (then *err is set). */
+static struct avltree_node *build(struct avltree_fns *fns, void **keys,
+                                  void **vals, size_t n, int *err);
+
+/* Join two subtrees and a node whose key lies between them, returns the new
+   root */
+static struct avltree_node *join(struct avltree_node *l,
+                                 struct avltree_node *mid,
+                                 struct avltree_node *r);
+
+/* Detach the smallest node of the subtree at *root and rebalance */
+static struct avltree_node *popmin(struct avltree_node **root);
 
 static inline int height(struct avltree_node *node)
 {
@@ -61,6 +73,17 @@ static inline int balancefactor(struct avltree_node *node)
   return height(node->left) - height(node->right);
 }
 
+static inline size_t count(struct avltree_node *node)
+{
+  return node ? node->count : 0;
+}
+
+static inline void update(struct avltree_node *node)
+{
+  node->height = 1 + MAX(height(node->left), height(node->right));
+  node->count = 1 + count(node->left) + count(node->right);
+}
+
 int avltree_init(struct avltree *tree, struct avltree_fns *fns)
 {
   if (!tree || !fns || !fns->cmp)
@@ -75,7 +98,7 @@ void avltree_clear(struct avltree *tree)
   if (!tree)
     return;
   struct avltree_node *node = tree->root;
-  clear(node, tree->fns);
+  clear(node, tree->fns, 0);
   tree->root = NULL;
   tree->size = 0;
 }
@@ -131,22 +154,338 @@ int avltree_remove(struct avltree *tree, void *key, void **dest)
 {
   if (!tree || !key)
     return -1;
-  int remf = 0;
-  tree->root = remove_node(tree->root, key, dest, tree->fns, &remf, 0);
-  if (remf)
-    tree->size--;
-  return remf ? 0 : -1;
+  struct avltree_node **path[AVLTREE_MAXHEIGHT];
+  struct avltree_node **link = &tree->root;
+  int top = 0;
+
+  while (*link) {
+    int cmp = tree->fns->cmp(key, (*link)->key);
+    if (cmp == 0)
+      break;
+    path[top++] = link;
+    link = cmp < 0 ? &(*link)->left : &(*link)->right;
+  }
+  struct avltree_node *node = *link;
+  if (!node)
+    return -1;
+
+  if (node->left && node->right) {
+    /* Move the successor into the node's place, its old parent is now the
+       deepest subtree that lost height */
+    int at = top;
+    path[top++] = link;
+    struct avltree_node **slink = &node->right;
+    while ((*slink)->left) {
+      path[top++] = slink;
+      slink = &(*slink)->left;
+    }
+    struct avltree_node *succ = *slink;
+    *slink = succ->right;
+    succ->left = node->left;
+    succ->right = node->right;
+    succ->height = node->height;
+    succ->count = node->count;
+    *link = succ;
+    if (top > at + 1)
+      path[at + 1] = &succ->right;
+  } else
+    *link = node->left ? node->left : node->right;
+
+  destroy_node(node, tree->fns, dest, 0);
+  tree->size--;
+  retrace(path, top);
+  return 0;
 }
 
 int avltree_insert(struct avltree *tree, void *key, void *val)
 {
   if (!tree || !key)
     return -1;
-  int insf = 0;
-  tree->root = insert_node(tree->root, key, val, tree->fns, &insf);
-  if (insf)
-    tree->size++;
-  return insf ? 0 : -1;
+  struct avltree_node **path[AVLTREE_MAXHEIGHT];
+  struct avltree_node **link = &tree->root;
+  int top = 0;
+
+  while (*link) {
+    int cmp = tree->fns->cmp(key, (*link)->key);
+    if (cmp == 0)
+      return -1;
+    path[top++] = link;
+    link = cmp < 0 ? &(*link)->left : &(*link)->right;
+  }
+  if (!(*link = create_node(key, val)))
+    return -1;
+  tree->size++;
+  retrace(path, top);
+  return 0;
+}
+
+struct avltree_node *avltree_first(struct avltree *tree)
+{
+  if (!tree || !tree->root)
+    return NULL;
+  struct avltree_node *node = tree->root;
+  while (node->left)
+    node = node->left;
+  return node;
+}
+
+struct avltree_node *avltree_last(struct avltree *tree)
+{
+  if (!tree || !tree->root)
+    return NULL;
+  struct avltree_node *node = tree->root;
+  while (node->right)
+    node = node->right;
+  return node;
+}
+
+struct avltree_node *avltree_lower_bound(struct avltree *tree, void *key)
+{
+  if (!tree || !key)
+    return NULL;
+  struct avltree_node *node = tree->root, *bound = NULL;
+  while (node) {
+    int cmp = tree->fns->cmp(key, node->key);
+    if (cmp == 0)
+      return node;
+    if (cmp < 0) {
+      bound = node;
+      node = node->left;
+    } else
+      node = node->right;
+  }
+  return bound;
+}
+
+struct avltree_node *avltree_upper_bound(struct avltree *tree, void *key)
+{
+  if (!tree || !key)
+    return NULL;
+  struct avltree_node *node = tree->root, *bound = NULL;
+  while (node) {
+    if (tree->fns->cmp(key, node->key) < 0) {
+      bound = node;
+      node = node->left;
+    } else
+      node = node->right;
+  }
+  return bound;
+}
+
+size_t avltree_range(struct avltree *tree, void *lo, void *hi,
+                     int (*cb)(struct avltree_node *, void *), void *arg)
+{
+  if (!tree || !cb)
+    return 0;
+  struct avltree_iter iter;
+  struct avltree_node *node;
+  size_t n = 0;
+
+  if (lo)
+    avltree_iter_seek(&iter, tree, lo);
+  else
+    avltree_iter_init(&iter, tree);
+  while ((node = avltree_iter_get(&iter))) {
+    if (hi && tree->fns->cmp(node->key, hi) >= 0)
+      break;
+    n++;
+    if (cb(node, arg))
+      break;
+    avltree_iter_inc(&iter);
+  }
+  return n;
+}
+
+struct avltree_node *avltree_select(struct avltree *tree, size_t k)
+{
+  if (!tree || k >= tree->size)
+    return NULL;
+  struct avltree_node *node = tree->root;
+  for (;;) {
+    size_t left = count(node->left);
+    if (k == left)
+      return node;
+    if (k < left)
+      node = node->left;
+    else {
+      k -= left + 1;
+      node = node->right;
+    }
+  }
+}
+
+size_t avltree_rank(struct avltree *tree, void *key)
+{
+  if (!tree || !key)
+    return 0;
+  struct avltree_node *node = tree->root;
+  size_t rank = 0;
+  while (node) {
+    int cmp = tree->fns->cmp(key, node->key);
+    if (cmp <= 0) {
+      if (cmp == 0)
+        return rank + count(node->left);
+      node = node->left;
+    } else {
+      rank += count(node->left) + 1;
+      node = node->right;
+    }
+  }
+  return rank;
+}
+
+size_t avltree_count_range(struct avltree *tree, void *lo, void *hi)
+{
+  if (!tree)
+    return 0;
+  size_t below = lo ? avltree_rank(tree, lo) : 0;
+  size_t upto = hi ? avltree_rank(tree, hi) : tree->size;
+  return upto > below ? upto - below : 0;
+}
+
+int avltree_build_sorted(struct avltree *tree, void **keys, void **vals,
+                         size_t n)
+{
+  if (!tree || !keys || tree->root)
+    return -1;
+  for (size_t i = 0; i < n; i++)
+    if (!keys[i] || (i && tree->fns->cmp(keys[i - 1], keys[i]) >= 0))
+      return -1;
+  int err = 0;
+  struct avltree_node *root = build(tree->fns, keys, vals, n, &err);
+  if (err)
+    return -1;
+  tree->root = root;
+  tree->size = n;
+  return 0;
+}
+
+int avltree_join(struct avltree *tree, struct avltree *other)
+{
+  if (!tree || !other || tree == other)
+    return -1;
+  if (!other->root)
+    return 0;
+  struct avltree_node *l = tree->root, *r = other->root;
+  int (*cmp)(void *, void *) = tree->fns->cmp;
+  if (l) {
+    if (cmp(avltree_last(tree)->key, avltree_first(other)->key) >= 0) {
+      if (cmp(avltree_last(other)->key, avltree_first(tree)->key) >= 0)
+        return -1;
+      l = other->root;
+      r = tree->root;
+    }
+    struct avltree_node *mid = popmin(&r);
+    tree->root = join(l, mid, r);
+  } else
+    tree->root = other->root;
+  tree->size += other->size;
+  other->root = NULL;
+  other->size = 0;
+  return 0;
+}
+
+int avltree_split(struct avltree *tree, void *key, struct avltree *dest)
+{
+  if (!tree || !key || !dest || dest == tree || dest->root)
+    return -1;
+  struct avltree_node *path[AVLTREE_MAXHEIGHT], *node = tree->root;
+  struct avltree_node *l = NULL, *r = NULL;
+  int top = 0;
+
+  while (node) {
+    path[top++] = node;
+    node = tree->fns->cmp(key, node->key) <= 0 ? node->left : node->right;
+  }
+  /* Bottom up, each node joins the side it belongs to together with its
+     subtree on the far side of the path */
+  while (top > 0) {
+    node = path[--top];
+    if (tree->fns->cmp(key, node->key) <= 0) {
+      struct avltree_node *sub = node->right;
+      r = join(r, node, sub);
+    } else {
+      struct avltree_node *sub = node->left;
+      l = join(sub, node, l);
+    }
+  }
+  tree->root = l;
+  tree->size = count(l);
+  dest->root = r;
+  dest->size = count(r);
+  return 0;
+}
+
+int avltree_iter_init(struct avltree_iter *iter, struct avltree *tree)
+{
+  if (!iter || !tree)
+    return -1;
+  iter->tree = tree;
+  iter->depth = 0;
+  for (struct avltree_node *node = tree->root; node; node = node->left)
+    iter->path[iter->depth++] = node;
+  return 0;
+}
+
+int avltree_iter_rinit(struct avltree_iter *iter, struct avltree *tree)
+{
+  if (!iter || !tree)
+    return -1;
+  iter->tree = tree;
+  iter->depth = 0;
+  for (struct avltree_node *node = tree->root; node; node = node->right)
+    iter->path[iter->depth++] = node;
+  return 0;
+}
+
+int avltree_iter_seek(struct avltree_iter *iter, struct avltree *tree,
+                      void *key)
+{
+  if (!iter || !tree || !key)
+    return -1;
+  iter->tree = tree;
+  seek(iter, key);
+  return 0;
+}
+
+void avltree_iter_inc(struct avltree_iter *iter)
+{
+  if (!iter || !iter->depth)
+    return;
+  struct avltree_node *node = iter->path[iter->depth - 1];
+  if (node->right) {
+    for (node = node->right; node; node = node->left)
+      iter->path[iter->depth++] = node;
+    return;
+  }
+  /* Climb until we leave a left subtree, its parent is the successor */
+  struct avltree_node *child;
+  do
+    child = iter->path[--iter->depth];
+  while (iter->depth && iter->path[iter->depth - 1]->right == child);
+}
+
+void avltree_iter_dec(struct avltree_iter *iter)
+{
+  if (!iter || !iter->depth)
+    return;
+  struct avltree_node *node = iter->path[iter->depth - 1];
+  if (node->left) {
+    for (node = node->left; node; node = node->right)
+      iter->path[iter->depth++] = node;
+    return;
+  }
+  struct avltree_node *child;
+  do
+    child = iter->path[--iter->depth];
+  while (iter->depth && iter->path[iter->depth - 1]->left == child);
+}
+
+struct avltree_node *avltree_iter_get(struct avltree_iter *iter)
+{
+  if (!iter || !iter->depth)
+    return NULL;
+  return iter->path[iter->depth - 1];
 }
 
 static struct avltree_node *create_node(void *key, void *val)
@@ -156,6 +495,7 @@ static struct avltree_node *create_node(void *key, void *val)
     return NULL;
   node->key = key;
   node->val = val;
+  node->count = 1;
   return node;
 }
 
@@ -173,15 +513,21 @@ static void destroy_node(struct avltree_node *node, struct avltree_fns *fns,
   free(node);
 }
 
-static void clear(struct avltree_node *node, struct avltree_fns *fns)
+static void clear(struct avltree_node *node, struct avltree_fns *fns,
+                  int unlink)
 {
-  if (!node)
-    return;
-  struct avltree_node *left = node->left;
-  struct avltree_node *right = node->right;
-  destroy_node(node, fns, NULL, 0);
-  clear(left, fns);
-  clear(right, fns);
+  while (node) {
+    struct avltree_node *left = node->left;
+    if (left) {
+      node->left = left->right;
+      left->right = node;
+      node = left;
+    } else {
+      struct avltree_node *right = node->right;
+      destroy_node(node, fns, NULL, unlink);
+      node = right;
+    }
+  }
 }
 
 static struct avltree_node *rotate_left(struct avltree_node *node)
@@ -192,8 +538,8 @@ static struct avltree_node *rotate_left(struct avltree_node *node)
   top->left = node;
   node->right = oldleft;
 
-  node->height = 1 + MAX(height(node->left), height(node->right));
-  top->height = 1 + MAX(height(top->left), height(top->right));
+  update(node);
+  update(top);
   return top;
 }
 
@@ -205,8 +551,8 @@ static struct avltree_node *rotate_right(struct avltree_node *node)
   top->right = node;
   node->left = oldright;
 
-  node->height = 1 + MAX(height(node->left), height(node->right));
-  top->height = 1 + MAX(height(top->left), height(top->right));
+  update(node);
+  update(top);
   return top;
 }
 
@@ -214,7 +560,7 @@ static struct avltree_node *rebalance(struct avltree_node *node)
 {
   if (!node)
     return NULL;
-  node->height = 1 + MAX(height(node->left), height(node->right));
+  update(node);
   int bf = balancefactor(node);
 
   if (bf > 1 && balancefactor(node->left) >= 0) /* LL */
@@ -232,66 +578,111 @@ static struct avltree_node *rebalance(struct avltree_node *node)
   return node;
 }
 
-static struct avltree_node *insert_node(struct avltree_node *node, void *key,
-                                        void *val, struct avltree_fns *fns,
-                                        int *insf)
+static void retrace(struct avltree_node **path[], int n)
 {
-  if (!node) {
-    struct avltree_node *new_node = create_node(key, val);
-    if (new_node)
-      *insf = 1;
-    return new_node;
+  while (n > 0) {
+    struct avltree_node **link = path[--n];
+    int old = (*link)->height;
+    *link = rebalance(*link);
+    if ((*link)->height == old)
+      break;
   }
-  int cmp = fns->cmp(key, node->key);
-  if (cmp > 0)
-    node->right = insert_node(node->right, key, val, fns, insf);
-  else if (cmp < 0)
-    node->left = insert_node(node->left, key, val, fns, insf);
-  else
-    return node;
+  while (n > 0) {
+    struct avltree_node *node = *path[--n];
+    node->count = 1 + count(node->left) + count(node->right);
+  }
+}
 
-  return rebalance(node);
+static void seek(struct avltree_iter *iter, void *key)
+{
+  struct avltree_node *node = iter->tree->root;
+  int bound = 0;
+  iter->depth = 0;
+  while (node) {
+    int cmp = iter->tree->fns->cmp(key, node->key);
+    iter->path[iter->depth++] = node;
+    if (cmp <= 0) {
+      bound = iter->depth;
+      if (cmp == 0)
+        break;
+      node = node->left;
+    } else
+      node = node->right;
+  }
+  iter->depth = bound;
 }
 
-static struct avltree_node *remove_node(struct avltree_node *node, void *key,
-                                        void **dest, struct avltree_fns *fns,
-                                        int *remf, int unlink)
+static struct avltree_node *build(struct avltree_fns *fns, void **keys,
+                                  void **vals, size_t n, int *err)
 {
-  if (!node)
+  if (n == 0)
+    return NULL;
+  size_t mid = n / 2;
+  struct avltree_node *left = build(fns, keys, vals, mid, err);
+  if (*err)
+    return NULL;
+  struct avltree_node *node = create_node(keys[mid], vals ? vals[mid] : NULL);
+  if (!node) {
+    *err = 1;
+    clear(left, fns, 1);
+    return NULL;
+  }
+  node->left = left;
+  node->right = build(fns, keys + mid + 1, vals ? vals + mid + 1 : NULL,
+                      n - mid - 1, err);
+  if (*err) {
+    clear(node, fns, 1);
     return NULL;
-  int cmp = fns->cmp(key, node->key);
-  if (cmp > 0)
-    node->right = remove_node(node->right, key, dest, fns, remf, unlink);
-  else if (cmp < 0)
-    node->left = remove_node(node->left, key, dest, fns, remf, unlink);
-  else {
-    *remf = 1;
-    if (!node->left && !node->right) {
-      destroy_node(node, fns, dest, unlink);
-      return NULL;
-    } else if (node->left && node->right) {
-      if (!unlink) {
-        if (fns->destroy_key)
-          fns->destroy_key(node->key);
-        if (dest)
-          *dest = node->val;
-        else if (fns->destroy_val)
-          fns->destroy_val(node->val);
-      }
-
-      struct avltree_node *succ = node->right;
-      while (succ->left)
-        succ = succ->left;
-
-      node->key = succ->key;
-      node->val = succ->val;
-      /* unlink the successor node */
-      node->right = remove_node(node->right, succ->key, NULL, fns, remf, 1);
-    } else {
-      struct avltree_node *child = node->left ? node->left : node->right;
-      destroy_node(node, fns, dest, unlink);
-      return child;
-    }
   }
-  return rebalance(node);
+  update(node);
+  return node;
+}
+
+static struct avltree_node *join(struct avltree_node *l,
+                                 struct avltree_node *mid,
+                                 struct avltree_node *r)
+{
+  struct avltree_node **path[AVLTREE_MAXHEIGHT], **link, *root;
+  int top = 0;
+
+  /* Walk down the inner spine of the taller side to a subtree whose height
+     is within one of the shorter side, mid replaces it */
+  if (height(l) > height(r) + 1) {
+    root = l;
+    for (link = &root; height(*link) > height(r) + 1;
+         link = &(*link)->right)
+      path[top++] = link;
+    mid->left = *link;
+    mid->right = r;
+  } else if (height(r) > height(l) + 1) {
+    root = r;
+    for (link = &root; height(*link) > height(l) + 1; link = &(*link)->left)
+      path[top++] = link;
+    mid->left = l;
+    mid->right = *link;
+  } else {
+    root = mid;
+    link = &root;
+    mid->left = l;
+    mid->right = r;
+  }
+  update(mid);
+  *link = mid;
+  retrace(path, top);
+  return root;
+}
+
+static struct avltree_node *popmin(struct avltree_node **root)
+{
+  struct avltree_node **path[AVLTREE_MAXHEIGHT], **link = root;
+  int top = 0;
+
+  while ((*link)->left) {
+    path[top++] = link;
+    link = &(*link)->left;
+  }
+  struct avltree_node *node = *link;
+  *link = node->right;
+  retrace(path, top);
+  return node;
 }
@@ -0,0 +1,539 @@
+/* collection - A generic data structure and algorithms library
+ * Copyright (C) 2025 Yixiang Qiu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <bptree.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Fewest keys in any node but the root */
+#define MINKEYS (BPTREE_ORDER / 2)
+
+/* Inner nodes below the root have more than MINKEYS children, so 24 levels
+   cover any tree that fits in memory */
+#define MAXDEPTH 24
+
+/* Only integer keys may be NULL, they are the value 0 */
+#define BADKEY(tree, key) (!(key) && (tree)->fns->cmp)
+
+static int keycmp(struct bptree *tree, void *a, void *b);
+
+/* Count the keys in node less than key, or not greater than key if upper is
+   set. Integer keys use a branch-free scan the compiler can vectorize, other
+   keys a binary search. */
+static int search(struct bptree *tree, struct bptree_node *node, void *key,
+                  int upper);
+
+/* Descend from the root to the leaf that covers key, recording each inner
+   node in path and the child taken in idx */
+static struct bptree_node *descend(struct bptree *tree, void *key,
+                                   struct bptree_node **path, int *idx,
+                                   int *depth);
+
+/* Find key, returns its index in *leaf or -1 if it is absent */
+static int locate(struct bptree *tree, void *key, struct bptree_node **leaf);
+
+static struct bptree_node *create_node(int leaf);
+
+/* Free a subtree, destroying the keys and values in its leaves */
+static void clear(struct bptree_node *node, struct bptree_fns *fns);
+
+/* Split a full leaf while inserting key and val at pos, the upper half moves
+   to right */
+static void split_leaf(struct bptree_node *leaf, struct bptree_node *right,
+                       int pos, void *key, void *val);
+
+/* Split a full inner node while inserting key and its right child at i, the
+   upper half moves to right. Returns the key promoted to the parent. */
+static void *split_inner(struct bptree_node *node, struct bptree_node *right,
+                         int i, void *key, struct bptree_node *child);
+
+/* Refill child i of parent after it fell below MINKEYS, by borrowing from a
+   sibling or merging with one */
+static void fix(struct bptree_node *parent, int i);
+
+/* Merge child j + 1 of parent into child j */
+static void merge(struct bptree_node *parent, int j);
+
+int bptree_init(struct bptree *tree, struct bptree_fns *fns)
+{
+  if (!tree || !fns)
+    return -1;
+  memset(tree, 0, sizeof(struct bptree));
+  tree->fns = fns;
+  return 0;
+}
+
+void bptree_fini(struct bptree *tree)
+{
+  if (!tree)
+    return;
+  bptree_clear(tree);
+}
+
+void bptree_clear(struct bptree *tree)
+{
+  if (!tree)
+    return;
+  if (tree->root)
+    clear(tree->root, tree->fns);
+  tree->root = NULL;
+  tree->size = 0;
+}
+
+int bptree_insert(struct bptree *tree, void *key, void *val)
+{
+  if (!tree || BADKEY(tree, key))
+    return -1;
+  if (!tree->root && !(tree->root = create_node(1)))
+    return -1;
+  struct bptree_node *path[MAXDEPTH], *spare[MAXDEPTH + 1];
+  int idx[MAXDEPTH], depth, nspare = 0, d;
+  struct bptree_node *leaf = descend(tree, key, path, idx, &depth);
+  int pos = search(tree, leaf, key, 0);
+
+  if (pos < leaf->n && keycmp(tree, leaf->keys[pos], key) == 0)
+    return -1;
+  if (leaf->n < BPTREE_ORDER) {
+    memmove(&leaf->keys[pos + 1], &leaf->keys[pos],
+            (leaf->n - pos) * sizeof(void *));
+    memmove(&leaf->vals[pos + 1], &leaf->vals[pos],
+            (leaf->n - pos) * sizeof(void *));
+    leaf->keys[pos] = key;
+    leaf->vals[pos] = val;
+    leaf->n++;
+    tree->size++;
+    return 0;
+  }
+
+  /* Allocate every node the split cascade needs before touching the tree, so
+     a failure leaves it as it was */
+  int need = 1;
+  for (d = depth - 1; d >= 0 && path[d]->n == BPTREE_ORDER; d--)
+    need++;
+  if (d < 0)
+    need++;
+  for (; nspare < need; nspare++) {
+    if (!(spare[nspare] = create_node(nspare == 0))) {
+      while (nspare > 0)
+        free(spare[--nspare]);
+      return -1;
+    }
+  }
+
+  split_leaf(leaf, spare[0], pos, key, val);
+  void *sep = spare[0]->keys[0];
+  struct bptree_node *right = spare[0];
+  int used = 1;
+  for (d = depth - 1; d >= 0; d--) {
+    struct bptree_node *node = path[d];
+    int i = idx[d];
+    if (node->n < BPTREE_ORDER) {
+      memmove(&node->keys[i + 1], &node->keys[i],
+              (node->n - i) * sizeof(void *));
+      memmove(&node->child[i + 2], &node->child[i + 1],
+              (node->n - i) * sizeof(struct bptree_node *));
+      node->keys[i] = sep;
+      node->child[i + 1] = right;
+      node->n++;
+      break;
+    }
+    sep = split_inner(node, spare[used], i, sep, right);
+    right = spare[used++];
+  }
+  if (d < 0) {
+    struct bptree_node *root = spare[used];
+    root->keys[0] = sep;
+    root->child[0] = tree->root;
+    root->child[1] = right;
+    root->n = 1;
+    tree->root = root;
+  }
+  tree->size++;
+  return 0;
+}
+
+int bptree_update(struct bptree *tree, void *key, void *newval, void **dest)
+{
+  if (!tree || BADKEY(tree, key))
+    return -1;
+  struct bptree_node *leaf;
+  int i = locate(tree, key, &leaf);
+  if (i < 0)
+    return -1;
+  if (dest)
+    *dest = leaf->vals[i];
+  else if (tree->fns->destroy_val)
+    tree->fns->destroy_val(leaf->vals[i]);
+  leaf->vals[i] = newval;
+  return 0;
+}
+
+int bptree_remove(struct bptree *tree, void *key, void **dest)
+{
+  if (!tree || BADKEY(tree, key) || !tree->root)
+    return -1;
+  struct bptree_node *path[MAXDEPTH];
+  int idx[MAXDEPTH], depth, d;
+  struct bptree_node *leaf = descend(tree, key, path, idx, &depth);
+  int pos = search(tree, leaf, key, 0);
+
+  if (pos == leaf->n || keycmp(tree, leaf->keys[pos], key) != 0)
+    return -1;
+  /* A separator is the smallest key of the subtree on its right. If that is
+     this key, hand the role to its successor, which shares the leaf since
+     leaves below the root hold at least MINKEYS keys. */
+  if (pos == 0) {
+    for (d = depth - 1; d >= 0 && idx[d] == 0; d--)
+      ;
+    if (d >= 0)
+      path[d]->keys[idx[d] - 1] = leaf->keys[1];
+  }
+
+  if (tree->fns->destroy_key)
+    tree->fns->destroy_key(leaf->keys[pos]);
+  if (dest)
+    *dest = leaf->vals[pos];
+  else if (tree->fns->destroy_val)
+    tree->fns->destroy_val(leaf->vals[pos]);
+  leaf->n--;
+  memmove(&leaf->keys[pos], &leaf->keys[pos + 1],
+          (leaf->n - pos) * sizeof(void *));
+  memmove(&leaf->vals[pos], &leaf->vals[pos + 1],
+          (leaf->n - pos) * sizeof(void *));
+  tree->size--;
+
+  struct bptree_node *node = leaf;
+  for (d = depth - 1; d >= 0 && node->n < MINKEYS; d--) {
+    fix(path[d], idx[d]);
+    node = path[d];
+  }
+  struct bptree_node *root = tree->root;
+  if (root->n == 0) {
+    tree->root = root->leaf ? NULL : root->child[0];
+    free(root);
+  }
+  return 0;
+}
+
+void *bptree_find(struct bptree *tree, void *key)
+{
+  if (!tree || BADKEY(tree, key))
+    return NULL;
+  struct bptree_node *leaf;
+  int i = locate(tree, key, &leaf);
+  return i < 0 ? NULL : leaf->vals[i];
+}
+
+int bptree_contains(struct bptree *tree, void *key)
+{
+  if (!tree || BADKEY(tree, key))
+    return 0;
+  struct bptree_node *leaf;
+  return locate(tree, key, &leaf) >= 0;
+}
+
+int bptree_iter_init(struct bptree_iter *iter, struct bptree *tree)
+{
+  if (!iter || !tree)
+    return -1;
+  struct bptree_node *node = tree->root;
+  while (node && !node->leaf)
+    node = node->child[0];
+  iter->leaf = node;
+  iter->idx = 0;
+  return 0;
+}
+
+int bptree_iter_rinit(struct bptree_iter *iter, struct bptree *tree)
+{
+  if (!iter || !tree)
+    return -1;
+  struct bptree_node *node = tree->root;
+  while (node && !node->leaf)
+    node = node->child[node->n];
+  iter->leaf = node;
+  iter->idx = node ? node->n - 1 : 0;
+  return 0;
+}
+
+int bptree_iter_seek(struct bptree_iter *iter, struct bptree *tree,
+                     void *key)
+{
+  if (!iter || !tree || BADKEY(tree, key))
+    return -1;
+  struct bptree_node *node = tree->root;
+  iter->leaf = NULL;
+  iter->idx = 0;
+  if (!node)
+    return 0;
+  while (!node->leaf)
+    node = node->child[search(tree, node, key, 1)];
+  iter->leaf = node;
+  iter->idx = search(tree, node, key, 0);
+  if (iter->idx == node->n) {
+    iter->leaf = node->next;
+    iter->idx = 0;
+  }
+  return 0;
+}
+
+void bptree_iter_inc(struct bptree_iter *iter)
+{
+  if (!iter || !iter->leaf)
+    return;
+  if (++iter->idx == iter->leaf->n) {
+    iter->leaf = iter->leaf->next;
+    iter->idx = 0;
+  }
+}
+
+void bptree_iter_dec(struct bptree_iter *iter)
+{
+  if (!iter || !iter->leaf)
+    return;
+  if (--iter->idx < 0) {
+    iter->leaf = iter->leaf->prev;
+    iter->idx = iter->leaf ? iter->leaf->n - 1 : 0;
+  }
+}
+
+int bptree_iter_get(struct bptree_iter *iter, void **key, void **val)
+{
+  if (!iter || !iter->leaf)
+    return -1;
+  if (key)
+    *key = iter->leaf->keys[iter->idx];
+  if (val)
+    *val = iter->leaf->vals[iter->idx];
+  return 0;
+}
+
+static int keycmp(struct bptree *tree, void *a, void *b)
+{
+  if (tree->fns->cmp)
+    return tree->fns->cmp(a, b);
+  intptr_t x = (intptr_t)a, y = (intptr_t)b;
+  return (x > y) - (x < y);
+}
+
+static int search(struct bptree *tree, struct bptree_node *node, void *key,
+                  int upper)
+{
+  int i, lo = 0, hi = node->n;
+
+  if (!tree->fns->cmp) {
+    intptr_t k = (intptr_t)key;
+    if (upper)
+      for (i = 0; i < hi; i++)
+        lo += (intptr_t)node->keys[i] <= k;
+    else
+      for (i = 0; i < hi; i++)
+        lo += (intptr_t)node->keys[i] < k;
+    return lo;
+  }
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    int cmp = tree->fns->cmp(node->keys[mid], key);
+    if (cmp < 0 || (upper && cmp == 0))
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+static struct bptree_node *descend(struct bptree *tree, void *key,
+                                   struct bptree_node **path, int *idx,
+                                   int *depth)
+{
+  struct bptree_node *node = tree->root;
+  *depth = 0;
+  while (!node->leaf) {
+    int i = search(tree, node, key, 1);
+    path[*depth] = node;
+    idx[(*depth)++] = i;
+    node = node->child[i];
+  }
+  return node;
+}
+
+static int locate(struct bptree *tree, void *key, struct bptree_node **leaf)
+{
+  struct bptree_node *node = tree->root;
+  if (!node)
+    return -1;
+  while (!node->leaf)
+    node = node->child[search(tree, node, key, 1)];
+  int i = search(tree, node, key, 0);
+  if (i == node->n || keycmp(tree, node->keys[i], key) != 0)
+    return -1;
+  *leaf = node;
+  return i;
+}
+
+static struct bptree_node *create_node(int leaf)
+{
+  struct bptree_node *node = calloc(1, sizeof(struct bptree_node));
+  if (!node)
+    return NULL;
+  node->leaf = leaf;
+  return node;
+}
+
+static void clear(struct bptree_node *node, struct bptree_fns *fns)
+{
+  int i;
+  if (!node->leaf) {
+    for (i = 0; i <= node->n; i++)
+      clear(node->child[i], fns);
+  } else {
+    for (i = 0; i < node->n; i++) {
+      if (fns->destroy_key)
+        fns->destroy_key(node->keys[i]);
+      if (fns->destroy_val)
+        fns->destroy_val(node->vals[i]);
+    }
+  }
+  free(node);
+}
+
+static void split_leaf(struct bptree_node *leaf, struct bptree_node *right,
+                       int pos, void *key, void *val)
+{
+  void *keys[BPTREE_ORDER + 1], *vals[BPTREE_ORDER + 1];
+  int half = (BPTREE_ORDER + 1) / 2;
+
+  memcpy(keys, leaf->keys, pos * sizeof(void *));
+  memcpy(vals, leaf->vals, pos * sizeof(void *));
+  keys[pos] = key;
+  vals[pos] = val;
+  memcpy(&keys[pos + 1], &leaf->keys[pos],
+         (BPTREE_ORDER - pos) * sizeof(void *));
+  memcpy(&vals[pos + 1], &leaf->vals[pos],
+         (BPTREE_ORDER - pos) * sizeof(void *));
+
+  memcpy(leaf->keys, keys, half * sizeof(void *));
+  memcpy(leaf->vals, vals, half * sizeof(void *));
+  leaf->n = half;
+  right->n = BPTREE_ORDER + 1 - half;
+  memcpy(right->keys, &keys[half], right->n * sizeof(void *));
+  memcpy(right->vals, &vals[half], right->n * sizeof(void *));
+
+  right->next = leaf->next;
+  if (right->next)
+    right->next->prev = right;
+  right->prev = leaf;
+  leaf->next = right;
+}
+
+static void *split_inner(struct bptree_node *node, struct bptree_node *right,
+                         int i, void *key, struct bptree_node *child)
+{
+  void *keys[BPTREE_ORDER + 1];
+  struct bptree_node *kids[BPTREE_ORDER + 2];
+  int half = BPTREE_ORDER / 2;
+
+  memcpy(keys, node->keys, i * sizeof(void *));
+  keys[i] = key;
+  memcpy(&keys[i + 1], &node->keys[i], (BPTREE_ORDER - i) * sizeof(void *));
+  memcpy(kids, node->child, (i + 1) * sizeof(struct bptree_node *));
+  kids[i + 1] = child;
+  memcpy(&kids[i + 2], &node->child[i + 1],
+         (BPTREE_ORDER - i) * sizeof(struct bptree_node *));
+
+  /* keys[half] moves up, each side keeps the children around its keys */
+  node->n = half;
+  memcpy(node->keys, keys, half * sizeof(void *));
+  memcpy(node->child, kids, (half + 1) * sizeof(struct bptree_node *));
+  right->n = BPTREE_ORDER - half;
+  memcpy(right->keys, &keys[half + 1], right->n * sizeof(void *));
+  memcpy(right->child, &kids[half + 1],
+         (right->n + 1) * sizeof(struct bptree_node *));
+  return keys[half];
+}
+
+static void fix(struct bptree_node *parent, int i)
+{
+  struct bptree_node *node = parent->child[i];
+  struct bptree_node *left = i > 0 ? parent->child[i - 1] : NULL;
+  struct bptree_node *right = i < parent->n ? parent->child[i + 1] : NULL;
+
+  if (left && left->n > MINKEYS) {
+    memmove(&node->keys[1], node->keys, node->n * sizeof(void *));
+    if (node->leaf) {
+      memmove(&node->vals[1], node->vals, node->n * sizeof(void *));
+      node->keys[0] = left->keys[left->n - 1];
+      node->vals[0] = left->vals[left->n - 1];
+      parent->keys[i - 1] = node->keys[0];
+    } else {
+      memmove(&node->child[1], node->child,
+              (node->n + 1) * sizeof(struct bptree_node *));
+      node->keys[0] = parent->keys[i - 1];
+      node->child[0] = left->child[left->n];
+      parent->keys[i - 1] = left->keys[left->n - 1];
+    }
+    left->n--;
+    node->n++;
+  } else if (right && right->n > MINKEYS) {
+    if (node->leaf) {
+      node->keys[node->n] = right->keys[0];
+      node->vals[node->n] = right->vals[0];
+      memmove(right->vals, &right->vals[1],
+              (right->n - 1) * sizeof(void *));
+    } else {
+      node->keys[node->n] = parent->keys[i];
+      node->child[node->n + 1] = right->child[0];
+      memmove(right->child, &right->child[1],
+              right->n * sizeof(struct bptree_node *));
+    }
+    void *first = right->keys[0];
+    memmove(right->keys, &right->keys[1], (right->n - 1) * sizeof(void *));
+    right->n--;
+    node->n++;
+    parent->keys[i] = node->leaf ? right->keys[0] : first;
+  } else if (left)
+    merge(parent, i - 1);
+  else
+    merge(parent, i);
+}
+
+static void merge(struct bptree_node *parent, int j)
+{
+  struct bptree_node *left = parent->child[j], *right = parent->child[j + 1];
+
+  if (left->leaf) {
+    memcpy(&left->keys[left->n], right->keys, right->n * sizeof(void *));
+    memcpy(&left->vals[left->n], right->vals, right->n * sizeof(void *));
+    left->n += right->n;
+    left->next = right->next;
+    if (left->next)
+      left->next->prev = left;
+  } else {
+    left->keys[left->n] = parent->keys[j];
+    memcpy(&left->keys[left->n + 1], right->keys, right->n * sizeof(void *));
+    memcpy(&left->child[left->n + 1], right->child,
+           (right->n + 1) * sizeof(struct bptree_node *));
+    left->n += right->n + 1;
+  }
+  free(right);
+  parent->n--;
+  memmove(&parent->keys[j], &parent->keys[j + 1],
+          (parent->n - j) * sizeof(void *));
+  memmove(&parent->child[j + 1], &parent->child[j + 2],
+          (parent->n - j) * sizeof(struct bptree_node *));
+}
@@ -0,0 +1,253 @@
+/* collection - A generic data structure and algorithms library
+ * Copyright (C) 2025 Yixiang Qiu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* clock_gettime and pthread_condattr_setclock */
+#define _POSIX_C_SOURCE 200809L
+
+#include <bqueue.h>
+#include <errno.h>
+#include <pthread.h>
+#include <queue.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <time.h>
+
+/* Polls of the lock-free size before a waiter goes to sleep, enough to catch
+   a producer that is already running on another core */
+#define SPIN 128
+
+/* Clock of the timed waits, monotonic so that stepping the wall clock neither
+   cuts a timeout short nor stretches it. macOS cannot select the clock of a
+   condition variable and keeps the realtime one. */
+#ifdef __APPLE__
+#define WAITCLOCK CLOCK_REALTIME
+#else
+#define WAITCLOCK CLOCK_MONOTONIC
+#endif
+
+#define FULL(bq) ((bq)->cap && queue_size(&(bq)->queue) >= (bq)->cap)
+#define CLOSED(bq) atomic_load_explicit(&(bq)->closed, memory_order_acquire)
+#define LOADSZ(bq) atomic_load_explicit(&(bq)->sz, memory_order_relaxed)
+#define SYNCSZ(bq)                                                             \
+  atomic_store_explicit(&(bq)->sz, queue_size(&(bq)->queue),                   \
+                        memory_order_release)
+
+/* Hint to the CPU that we are busy waiting */
+static inline void relax(void);
+
+/* Initialize a condition variable whose timed waits use WAITCLOCK */
+static int condinit(pthread_cond_t *cond);
+
+/* Lock the queue once an element is available, waiting until the absolute
+   deadline abs (forever when NULL). Returns -1 with the lock released and
+   errno set when the queue is closed and empty or the deadline passed. */
+static int acquire(struct bqueue *bq, const struct timespec *abs);
+
+/* Wake one sleeping producer per freed slot, called with the lock held */
+static void wakeenq(struct bqueue *bq, size_t nfreed);
+
+int bqueue_init(struct bqueue *bq, size_t elesz, size_t cap,
+                void (*destroy)(void *))
+{
+  if (!bq || !elesz)
+    return -1;
+  if (queue_init(&bq->queue, elesz, destroy) == -1)
+    return -1;
+  if (pthread_mutex_init(&bq->lock, NULL))
+    goto fail_lock;
+  if (condinit(&bq->notempty) == -1)
+    goto fail_notempty;
+  if (condinit(&bq->notfull) == -1)
+    goto fail_notfull;
+  bq->cap = cap;
+  bq->nwaitdeq = bq->nwaitenq = 0;
+  atomic_init(&bq->sz, 0);
+  atomic_init(&bq->closed, 0);
+  return 0;
+
+fail_notfull:
+  pthread_cond_destroy(&bq->notempty);
+fail_notempty:
+  pthread_mutex_destroy(&bq->lock);
+fail_lock:
+  queue_fini(&bq->queue);
+  return -1;
+}
+
+void bqueue_fini(struct bqueue *bq)
+{
+  if (!bq)
+    return;
+  queue_fini(&bq->queue);
+  pthread_cond_destroy(&bq->notfull);
+  pthread_cond_destroy(&bq->notempty);
+  pthread_mutex_destroy(&bq->lock);
+}
+
+size_t bqueue_size(struct bqueue *bq)
+{
+  if (!bq)
+    return 0;
+  return LOADSZ(bq);
+}
+
+int bqueue_enq(struct bqueue *bq, void *ele)
+{
+  if (!bq || !ele)
+    return -1;
+  for (int i = 0; i < SPIN && bq->cap && LOADSZ(bq) >= bq->cap && !CLOSED(bq);
+       i++)
+    relax();
+
+  pthread_mutex_lock(&bq->lock);
+  while (!CLOSED(bq) && FULL(bq)) {
+    bq->nwaitenq++;
+    pthread_cond_wait(&bq->notfull, &bq->lock);
+    bq->nwaitenq--;
+  }
+  if (CLOSED(bq)) {
+    pthread_mutex_unlock(&bq->lock);
+    errno = EPIPE;
+    return -1;
+  }
+  if (queue_enq(&bq->queue, ele) == -1) {
+    pthread_mutex_unlock(&bq->lock);
+    return -1;
+  }
+  SYNCSZ(bq);
+  if (bq->nwaitdeq)
+    pthread_cond_signal(&bq->notempty);
+  pthread_mutex_unlock(&bq->lock);
+  return 0;
+}
+
+int bqueue_deq(struct bqueue *bq, void *dest)
+{
+  if (!bq || acquire(bq, NULL) == -1)
+    return -1;
+  queue_deq(&bq->queue, dest);
+  SYNCSZ(bq);
+  wakeenq(bq, 1);
+  pthread_mutex_unlock(&bq->lock);
+  return 0;
+}
+
+int bqueue_deq_timeout(struct bqueue *bq, void *dest, unsigned long ms)
+{
+  if (!bq)
+    return -1;
+  struct timespec abs;
+  clock_gettime(WAITCLOCK, &abs);
+  abs.tv_sec += (time_t)(ms / 1000);
+  abs.tv_nsec += (long)(ms % 1000) * 1000000L;
+  if (abs.tv_nsec >= 1000000000L) {
+    abs.tv_sec++;
+    abs.tv_nsec -= 1000000000L;
+  }
+  if (acquire(bq, &abs) == -1)
+    return -1;
+  queue_deq(&bq->queue, dest);
+  SYNCSZ(bq);
+  wakeenq(bq, 1);
+  pthread_mutex_unlock(&bq->lock);
+  return 0;
+}
+
+size_t bqueue_drain_n(struct bqueue *bq, void *dest, size_t n)
+{
+  if (!bq || !dest || !n || acquire(bq, NULL) == -1)
+    return 0;
+  size_t elesz = bq->queue.deq.elesz, m = 0;
+  while (m < n && !queue_empty(&bq->queue)) {
+    queue_deq(&bq->queue, (char *)dest + m * elesz);
+    m++;
+  }
+  SYNCSZ(bq);
+  wakeenq(bq, m);
+  pthread_mutex_unlock(&bq->lock);
+  return m;
+}
+
+void bqueue_close(struct bqueue *bq)
+{
+  if (!bq)
+    return;
+  pthread_mutex_lock(&bq->lock);
+  atomic_store_explicit(&bq->closed, 1, memory_order_release);
+  pthread_cond_broadcast(&bq->notempty);
+  pthread_cond_broadcast(&bq->notfull);
+  pthread_mutex_unlock(&bq->lock);
+}
+
+static inline void relax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  __asm__ __volatile__("yield");
+#endif
+}
+
+static int condinit(pthread_cond_t *cond)
+{
+  pthread_condattr_t attr;
+  if (pthread_condattr_init(&attr))
+    return -1;
+  int rc = 0;
+#ifndef __APPLE__
+  rc = pthread_condattr_setclock(&attr, WAITCLOCK);
+#endif
+  if (!rc)
+    rc = pthread_cond_init(cond, &attr);
+  pthread_condattr_destroy(&attr);
+  return rc ? -1 : 0;
+}
+
+static int acquire(struct bqueue *bq, const struct timespec *abs)
+{
+  for (int i = 0; i < SPIN && !LOADSZ(bq) && !CLOSED(bq); i++)
+    relax();
+
+  pthread_mutex_lock(&bq->lock);
+  while (queue_empty(&bq->queue) && !CLOSED(bq)) {
+    int rc;
+    bq->nwaitdeq++;
+    if (abs)
+      rc = pthread_cond_timedwait(&bq->notempty, &bq->lock, abs);
+    else
+      rc = pthread_cond_wait(&bq->notempty, &bq->lock);
+    bq->nwaitdeq--;
+    if (rc == ETIMEDOUT && queue_empty(&bq->queue)) {
+      pthread_mutex_unlock(&bq->lock);
+      errno = ETIMEDOUT;
+      return -1;
+    }
+  }
+  if (queue_empty(&bq->queue)) {
+    pthread_mutex_unlock(&bq->lock);
+    errno = EPIPE;
+    return -1;
+  }
+  return 0;
+}
+
+static void wakeenq(struct bqueue *bq, size_t nfreed)
+{
+  size_t n = nfreed < bq->nwaitenq ? nfreed : bq->nwaitenq;
+  while (n--)
+    pthread_cond_signal(&bq->notfull);
+}
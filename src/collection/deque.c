@@ -23,10 +23,13 @@
 #include <string.h>
 
 #define MINCAP 16
-#define GROWFACTOR 2
+#define GROWFACTOR 2 /* Must keep the capacity a power of two */
 
+/* The capacity is always zero or a power of two, so wrapping a physical index
+   is a mask instead of a division */
+#define MASK(deq) ((deq)->cap - 1)
 #define PINDEX(deq, idx)                                                       \
-  (((deq)->head + (idx)) % (deq)->cap) /* Get the physical index */
+  (((deq)->head + (idx)) & MASK(deq)) /* Get the physical index */
 #define GET(buf, idx, elesz)                                                   \
   ((void *)((char *)(buf) + (idx) * (elesz))) /* Get the element  */
 
@@ -54,6 +57,12 @@ static void destroy_r(struct deque *deq, size_t start, size_t end);
 
 static int expand(struct deque *deq);
 
+/* Grow the buffer so that it holds at least n elements */
+static int reserve(struct deque *deq, size_t n);
+
+/* Smallest power of two not below n, 0 on overflow */
+static size_t roundcap(size_t n);
+
 int deq_init(struct deque *deq, size_t elesz, void (*destroy)(void *))
 {
   if (!deq || !elesz)
@@ -88,11 +97,21 @@ int deq_resize(struct deque *deq, size_t newsize)
     return 0;
   if (newsize > deq->sz) {
     if (newsize <= deq->cap) {
+      /* Zero the new slots in place, they may wrap past the buffer end */
+      size_t first = PINDEX(deq, deq->sz), n = newsize - deq->sz;
+      size_t run = n < deq->cap - first ? n : deq->cap - first;
+      memset(GET(deq->buf, first, deq->elesz), 0, run * deq->elesz);
+      memset(deq->buf, 0, (n - run) * deq->elesz);
       deq->sz = newsize;
       return 0;
     } else {
-      overflowcheck(deq->elesz, newsize);
-      void *newbuf = malloc(newsize * deq->elesz);
+      size_t newcap = roundcap(newsize);
+      if (!newcap) {
+        errno = ERANGE;
+        return -1;
+      }
+      overflowcheck(deq->elesz, newcap);
+      void *newbuf = malloc(newcap * deq->elesz);
       if (!newbuf)
         return -1;
       flatten(deq, newbuf);
@@ -100,7 +119,7 @@ int deq_resize(struct deque *deq, size_t newsize)
              (newsize - deq->sz) * deq->elesz);
       free(deq->buf);
       deq->buf = newbuf;
-      deq->cap = newsize;
+      deq->cap = newcap;
       deq->sz = newsize;
       deq->head = 0;
       return 0;
@@ -112,19 +131,29 @@ int deq_resize(struct deque *deq, size_t newsize)
   }
 }
 
+int deq_reserve(struct deque *deq, size_t n)
+{
+  if (!deq)
+    return -1;
+  if (n <= deq->cap)
+    return 0;
+  return reserve(deq, n);
+}
+
 int deq_shrink(struct deque *deq)
 {
   if (!deq)
     return -1;
-  if (deq->sz == deq->cap || !deq->sz)
+  size_t newcap = roundcap(deq->sz);
+  if (newcap == deq->cap || !deq->sz)
     return 0;
-  void *newbuf = malloc(deq->sz * deq->elesz);
+  void *newbuf = malloc(newcap * deq->elesz);
   if (!newbuf)
     return -1;
   flatten(deq, newbuf);
   free(deq->buf);
   deq->buf = newbuf;
-  deq->cap = deq->sz;
+  deq->cap = newcap;
   deq->head = 0;
   return 0;
 }
@@ -161,7 +190,7 @@ int deq_insert(struct deque *deq, size_t idx, void *ele)
   {
     if (pidx > phead) {
       ln = pidx - phead;
-      rn = (deq->cap - pidx - 1) + pend;
+      rn = (deq->cap - pidx) + pend;
       if (rn < ln) {
         shiftright(deq, idx + rn, rn);
       } else {
@@ -263,7 +292,7 @@ int deq_pushfront(struct deque *deq, void *ele)
     return -1;
   if (deq->sz == deq->cap && expand(deq) == -1)
     return -1;
-  size_t newhead = (deq->head + deq->cap - 1) % deq->cap;
+  size_t newhead = (deq->head - 1) & MASK(deq);
   memcpy(GET(deq->buf, newhead, deq->elesz), ele, deq->elesz);
   deq->head = newhead;
   deq->sz++;
@@ -290,11 +319,62 @@ int deq_popfront(struct deque *deq, void *dest)
     memcpy(dest, deq_front(deq), deq->elesz);
   else if (deq->destroy)
     deq->destroy(deq_front(deq));
-  deq->head = (deq->head + 1) % deq->cap;
+  deq->head = (deq->head + 1) & MASK(deq);
   deq->sz--;
   return 0;
 }
 
+int deq_pushback_n(struct deque *deq, void *base, size_t n)
+{
+  if (!deq || (!base && n))
+    return -1;
+  if (n > SIZE_MAX - deq->sz) {
+    errno = ERANGE;
+    return -1;
+  }
+  if (deq->sz + n > deq->cap && reserve(deq, deq->sz + n) == -1)
+    return -1;
+  if (!n)
+    return 0;
+  size_t pend = PINDEX(deq, deq->sz);
+  size_t first = deq->cap - pend < n ? deq->cap - pend : n;
+  memcpy(GET(deq->buf, pend, deq->elesz), base, first * deq->elesz);
+  memcpy(deq->buf, GET(base, first, deq->elesz), (n - first) * deq->elesz);
+  deq->sz += n;
+  return 0;
+}
+
+int deq_popfront_n(struct deque *deq, void *dest, size_t n)
+{
+  if (!deq || n > deq->sz)
+    return -1;
+  if (!n)
+    return 0;
+  if (dest) {
+    size_t first = deq->cap - deq->head < n ? deq->cap - deq->head : n;
+    memcpy(dest, GET(deq->buf, deq->head, deq->elesz), first * deq->elesz);
+    memcpy(GET(dest, first, deq->elesz), deq->buf, (n - first) * deq->elesz);
+  } else
+    destroy_r(deq, 0, n);
+  deq->head = PINDEX(deq, n);
+  deq->sz -= n;
+  return 0;
+}
+
+int deq_spans(const struct deque *deq, void **a, size_t *alen, void **b,
+              size_t *blen)
+{
+  if (!deq || !a || !alen || !b || !blen)
+    return -1;
+  size_t first = deq->cap - deq->head < deq->sz ? deq->cap - deq->head
+                                                 : deq->sz;
+  *a = first ? GET(deq->buf, deq->head, deq->elesz) : NULL;
+  *alen = first;
+  *b = deq->sz > first ? deq->buf : NULL;
+  *blen = deq->sz - first;
+  return 0;
+}
+
 void deq_clear(struct deque *deq)
 {
   if (!deq)
@@ -306,6 +386,10 @@ void deq_clear(struct deque *deq)
 
 static int expand(struct deque *deq)
 {
+  if (deq->cap > SIZE_MAX / GROWFACTOR) {
+    errno = ERANGE;
+    return -1;
+  }
   size_t newcap = deq->cap ? deq->cap * GROWFACTOR : MINCAP;
   overflowcheck(deq->elesz, newcap);
   void *newbuf = malloc(newcap * deq->elesz);
@@ -319,6 +403,38 @@ static int expand(struct deque *deq)
   return 0;
 }
 
+static size_t roundcap(size_t n)
+{
+  size_t cap = 1;
+  while (cap < n) {
+    if (cap > SIZE_MAX / 2)
+      return 0;
+    cap <<= 1;
+  }
+  return cap;
+}
+
+static int reserve(struct deque *deq, size_t n)
+{
+  size_t newcap = roundcap(n);
+  if (!newcap) {
+    errno = ERANGE;
+    return -1;
+  }
+  if (newcap < MINCAP)
+    newcap = MINCAP;
+  overflowcheck(deq->elesz, newcap);
+  void *newbuf = malloc(newcap * deq->elesz);
+  if (!newbuf)
+    return -1;
+  flatten(deq, newbuf);
+  free(deq->buf);
+  deq->buf = newbuf;
+  deq->cap = newcap;
+  deq->head = 0;
+  return 0;
+}
+
 static void destroy_r(struct deque *deq, size_t start, size_t end)
 {
   if (!deq || start >= end || start >= deq->sz)
@@ -354,18 +470,36 @@ static void flatten(struct deque *deq, void *buf)
   }
 }
 
+/* Both shifts move the longest runs that wrap neither the source nor the
+   destination, the ring is split at most twice so that is three memmoves */
 static inline void shiftleft(struct deque *deq, size_t dest, size_t n)
 {
-  for (size_t i = 0; i < n; i++)
-    memcpy(GET(deq->buf, PINDEX(deq, dest + i), deq->elesz),
-           GET(deq->buf, PINDEX(deq, dest + i + 1), deq->elesz), deq->elesz);
+  for (size_t done = 0, k; done < n; done += k) {
+    size_t pd = PINDEX(deq, dest + done);
+    size_t ps = PINDEX(deq, dest + done + 1);
+    k = n - done;
+    if (k > deq->cap - pd)
+      k = deq->cap - pd;
+    if (k > deq->cap - ps)
+      k = deq->cap - ps;
+    memmove(GET(deq->buf, pd, deq->elesz), GET(deq->buf, ps, deq->elesz),
+            k * deq->elesz);
+  }
 }
 
 static inline void shiftright(struct deque *deq, size_t dest, size_t n)
 {
-  for (size_t i = 0; i < n; i++)
-    memcpy(GET(deq->buf, PINDEX(deq, dest - i), deq->elesz),
-           GET(deq->buf, PINDEX(deq, dest - i - 1), deq->elesz), deq->elesz);
+  for (size_t done = 0, k; done < n; done += k) {
+    size_t pd = PINDEX(deq, dest - done);
+    size_t ps = PINDEX(deq, dest - done - 1);
+    k = n - done;
+    if (k > pd + 1)
+      k = pd + 1;
+    if (k > ps + 1)
+      k = ps + 1;
+    memmove(GET(deq->buf, pd + 1 - k, deq->elesz),
+            GET(deq->buf, ps + 1 - k, deq->elesz), k * deq->elesz);
+  }
 }
 
 int deq_iter_init(struct deque_iter *iter, struct deque *deq)
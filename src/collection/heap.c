@@ -17,26 +17,76 @@
 
 #include <heap.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <string.h>
-#include <util.h>
 #include <vector.h>
 
-#define PARENT(idx) (((idx) - 1) / 2)
-#define LEFT(idx) (2 * (idx) + 1)
-#define RIGHT(idx) (2 * (idx) + 2)
+#define SMALLELE 16 /* Largest element size that defaults to a 4-ary heap */
 
-static int shiftup(struct heap *heap, size_t idx);
-static int shiftdown(struct heap *heap, size_t idx);
+/* d-ary heap navigation, the arity is a power of two so lg is its log2 */
+#define PARENT(idx, lg) (((idx) - 1) >> (lg))
+#define CHILD(idx, lg) (((idx) << (lg)) + 1)
+
+#define AT(heap, idx)                                                          \
+  ((void *)((heap)->vec.buf + (idx) * (heap)->vec.elesz)) /* Raw slot */
+
+#define NOPOS SIZE_MAX /* Position of a released handle */
+#define HND(ih, idx) (((size_t *)vec_raw(&(ih)->hnd))[idx]) /* Slot handle */
+#define POS(ih, h) (((size_t *)vec_raw(&(ih)->pos))[h])     /* Handle slot */
+
+/* Sift ele up from the hole at idx: parents that order after ele move down
+   one level, then ele is written once into the final hole. ele must not live
+   in a slot the hole can pass through. With ih, h is the handle of ele and the
+   handles follow their elements. */
+static void shiftup(struct heap *heap, struct iheap *ih, size_t idx,
+                    const void *ele, size_t h);
+
+/* Sift ele down from the hole at idx, moving the first child up each level,
+   with the same rules as shiftup */
+static void shiftdown(struct heap *heap, struct iheap *ih, size_t idx,
+                      const void *ele, size_t h);
+
+/* Restore the order around idx after the element there changed, ele holds a
+   copy of it outside the heap */
+static void resift(struct heap *heap, struct iheap *ih, size_t idx,
+                   const void *ele, size_t h);
+
+/* Floyd heapify, sift down every internal node from the last one up. tmp is
+   scratch space for one element outside the heap. */
+static void heapify(struct heap *heap, void *tmp);
 
 int heap_init(struct heap *heap, size_t elesz, int (*cmp)(void *, void *),
               void (*destroy)(void *))
+{
+  return heap_init_arity(heap, elesz, elesz <= SMALLELE ? 4 : 2, cmp, destroy);
+}
+
+int heap_init_arity(struct heap *heap, size_t elesz, size_t arity,
+                    int (*cmp)(void *, void *), void (*destroy)(void *))
 {
   if (!heap || !elesz || !cmp)
     return -1;
+  if (arity != 2 && arity != 4 && arity != 8)
+    return -1;
   heap->cmp = cmp;
+  heap->arity = arity;
   return vec_init(&heap->vec, elesz, destroy);
 }
 
+int heap_init_from(struct heap *heap, void *base, size_t n, size_t elesz,
+                   int (*cmp)(void *, void *), void (*destroy)(void *))
+{
+  if (!base && n)
+    return -1;
+  if (heap_init(heap, elesz, cmp, destroy) == -1)
+    return -1;
+  if (heap_push_bulk(heap, base, n) == -1) {
+    heap_fini(heap);
+    return -1;
+  }
+  return 0;
+}
+
 void heap_fini(struct heap *heap)
 {
   if (!heap)
@@ -48,11 +98,15 @@ int heap_push(struct heap *heap, void *ele)
 {
   if (!heap || !ele)
     return -1;
-  if (vec_pushback(&heap->vec, ele) == -1)
-    return -1;
-  if (vec_size(&heap->vec) == 1)
-    return 0;
-  return shiftup(heap, heap->vec.sz - 1);
+  /* Grow by one slot and sift the hole up, ele is copied in only once */
+  size_t sz = vec_size(&heap->vec);
+  if (sz == vec_capacity(&heap->vec)) {
+    if (vec_pushback(&heap->vec, ele) == -1)
+      return -1;
+  } else
+    heap->vec.sz++;
+  shiftup(heap, NULL, sz, ele, 0);
+  return 0;
 }
 
 int heap_pop(struct heap *heap, void *dest)
@@ -65,16 +119,60 @@ int heap_pop(struct heap *heap, void *dest)
   else if (heap->vec.destroy)
     heap->vec.destroy(vec_raw(&heap->vec));
 
-  /* Move semantic only no destroy for tail element */
-  if (vec_size(&heap->vec) > 1)
-    memcpy(vec_raw(&heap->vec), vec_at(&heap->vec, vec_size(&heap->vec) - 1),
-           heap->vec.elesz);
-
+  /* Move semantic only no destroy for tail element, it stays in its slot past
+     the end while the hole at the root sifts down */
   heap->vec.sz--;
+  if (!vec_empty(&heap->vec))
+    shiftdown(heap, NULL, 0, AT(heap, heap->vec.sz), 0);
+  return 0;
+}
 
-  if (vec_empty(&heap->vec))
+int heap_push_bulk(struct heap *heap, void *base, size_t n)
+{
+  if (!heap || (!base && n))
+    return -1;
+  if (!n)
     return 0;
-  return shiftdown(heap, 0);
+  size_t oldsz = vec_size(&heap->vec);
+  /* One extra slot past the end is kept as scratch for heapify */
+  if (vec_reserve(&heap->vec, oldsz + n + 1) == -1)
+    return -1;
+  heap->vec.sz = oldsz + n;
+  memcpy(AT(heap, oldsz), base, n * heap->vec.elesz);
+
+  /* Sifting up costs O(n log size), heapify O(size), so only sift a batch
+     that is small next to the heap */
+  if (n < oldsz / 8) {
+    for (size_t i = 0; i < n; i++)
+      shiftup(heap, NULL, oldsz + i, (char *)base + i * heap->vec.elesz, 0);
+  } else
+    heapify(heap, AT(heap, oldsz + n));
+  return 0;
+}
+
+int heap_replace_top(struct heap *heap, void *ele, void *dest)
+{
+  if (!heap || !ele || vec_empty(&heap->vec))
+    return -1;
+  void *top = vec_raw(&heap->vec);
+  if (dest)
+    memcpy(dest, top, heap->vec.elesz);
+  else if (heap->vec.destroy)
+    heap->vec.destroy(top);
+  shiftdown(heap, NULL, 0, ele, 0);
+  return 0;
+}
+
+int heap_topk(struct heap *heap, void *ele, size_t k)
+{
+  if (!heap || !ele || !k)
+    return -1;
+  if (vec_size(&heap->vec) < k)
+    return heap_push(heap, ele);
+
+  if (heap->cmp(ele, vec_raw(&heap->vec)) <= 0)
+    return 1;
+  return heap_replace_top(heap, ele, NULL);
 }
 
 void *heap_peek(struct heap *heap)
@@ -91,38 +189,212 @@ void heap_clear(struct heap *heap)
   vec_clear(&heap->vec);
 }
 
-static int shiftup(struct heap *heap, size_t idx)
+static inline void place(struct iheap *ih, size_t idx, size_t h)
 {
-  if (!heap || idx >= heap->vec.sz)
-    return -1;
-  size_t p = PARENT(idx);
-  while (idx && heap->cmp(vec_at(&heap->vec, idx), vec_at(&heap->vec, p)) < 0) {
-    swap(vec_at(&heap->vec, idx), vec_at(&heap->vec, p), heap->vec.elesz);
+  HND(ih, idx) = h;
+  POS(ih, h) = idx;
+}
+
+static void shiftup(struct heap *heap, struct iheap *ih, size_t idx,
+                    const void *ele, size_t h)
+{
+  unsigned lg = __builtin_ctzl(heap->arity);
+  size_t elesz = heap->vec.elesz;
+  while (idx) {
+    size_t p = PARENT(idx, lg);
+    if (heap->cmp((void *)ele, AT(heap, p)) >= 0)
+      break;
+    memcpy(AT(heap, idx), AT(heap, p), elesz);
+    if (ih)
+      place(ih, idx, HND(ih, p));
     idx = p;
-    p = PARENT(idx);
   }
-  return 0;
+  memcpy(AT(heap, idx), ele, elesz);
+  if (ih)
+    place(ih, idx, h);
 }
 
-static int shiftdown(struct heap *heap, size_t idx)
+static void shiftdown(struct heap *heap, struct iheap *ih, size_t idx,
+                      const void *ele, size_t h)
 {
-  if (!heap)
-    return -1;
+  unsigned lg = __builtin_ctzl(heap->arity);
+  size_t sz = heap->vec.sz, elesz = heap->vec.elesz;
   while (1) {
-    size_t i = idx;
-    size_t l = LEFT(idx);
-    size_t r = RIGHT(idx);
-
-    if (l < heap->vec.sz &&
-        heap->cmp(vec_at(&heap->vec, l), vec_at(&heap->vec, i)) < 0)
-      i = l;
-    if (r < heap->vec.sz &&
-        heap->cmp(vec_at(&heap->vec, r), vec_at(&heap->vec, i)) < 0)
-      i = r;
-    if (i == idx)
+    size_t c = CHILD(idx, lg);
+    if (c >= sz)
+      break;
+    size_t end = c + heap->arity;
+    if (end > sz)
+      end = sz;
+
+    /* The children are adjacent, scan them for the first in order */
+    size_t best = c;
+    for (c++; c < end; c++) {
+      if (heap->cmp(AT(heap, c), AT(heap, best)) < 0)
+        best = c;
+    }
+    if (heap->cmp(AT(heap, best), (void *)ele) >= 0)
       break;
-    swap(vec_at(&heap->vec, idx), vec_at(&heap->vec, i), heap->vec.elesz);
-    idx = i;
+    memcpy(AT(heap, idx), AT(heap, best), elesz);
+    if (ih)
+      place(ih, idx, HND(ih, best));
+    idx = best;
+  }
+  memcpy(AT(heap, idx), ele, elesz);
+  if (ih)
+    place(ih, idx, h);
+}
+
+static void resift(struct heap *heap, struct iheap *ih, size_t idx,
+                   const void *ele, size_t h)
+{
+  unsigned lg = __builtin_ctzl(heap->arity);
+  if (idx && heap->cmp((void *)ele, AT(heap, PARENT(idx, lg))) < 0)
+    shiftup(heap, ih, idx, ele, h);
+  else
+    shiftdown(heap, ih, idx, ele, h);
+}
+
+static void heapify(struct heap *heap, void *tmp)
+{
+  size_t n = vec_size(&heap->vec);
+  if (n <= 1)
+    return;
+  unsigned lg = __builtin_ctzl(heap->arity);
+  for (size_t i = PARENT(n - 1, lg) + 1; i-- > 0;) {
+    memcpy(tmp, AT(heap, i), heap->vec.elesz);
+    shiftdown(heap, NULL, i, tmp, 0);
   }
+}
+
+int iheap_init(struct iheap *ih, size_t elesz, int (*cmp)(void *, void *),
+               void (*destroy)(void *))
+{
+  if (!ih)
+    return -1;
+  if (heap_init(&ih->heap, elesz, cmp, destroy) == -1)
+    return -1;
+  vec_init(&ih->pos, sizeof(size_t), NULL);
+  vec_init(&ih->hnd, sizeof(size_t), NULL);
+  vec_init(&ih->freeh, sizeof(size_t), NULL);
+  return 0;
+}
+
+void iheap_fini(struct iheap *ih)
+{
+  if (!ih)
+    return;
+  heap_fini(&ih->heap);
+  vec_fini(&ih->pos);
+  vec_fini(&ih->hnd);
+  vec_fini(&ih->freeh);
+}
+
+int iheap_push(struct iheap *ih, void *ele, size_t *handle)
+{
+  if (!ih || !ele)
+    return -1;
+  struct heap *heap = &ih->heap;
+  size_t sz = vec_size(&heap->vec);
+
+  /* Keep one spare slot past the end so iheap_update never allocates */
+  if (vec_reserve(&heap->vec, sz + 2) == -1 ||
+      vec_reserve(&ih->hnd, sz + 1) == -1)
+    return -1;
+  ih->hnd.sz = sz + 1;
+
+  size_t h;
+  if (!vec_empty(&ih->freeh)) {
+    vec_popback(&ih->freeh, &h);
+  } else {
+    h = vec_size(&ih->pos);
+    size_t none = NOPOS;
+    if (vec_pushback(&ih->pos, &none) == -1) {
+      ih->hnd.sz = sz;
+      return -1;
+    }
+  }
+
+  heap->vec.sz++;
+  shiftup(heap, ih, sz, ele, h);
+  if (handle)
+    *handle = h;
+  return 0;
+}
+
+/* Release the handle and remove the element at idx, the tail element fills
+   the hole */
+static void detach(struct iheap *ih, size_t idx, void *dest)
+{
+  struct heap *heap = &ih->heap;
+  size_t h = HND(ih, idx);
+  if (dest)
+    memcpy(dest, AT(heap, idx), heap->vec.elesz);
+  else if (heap->vec.destroy)
+    heap->vec.destroy(AT(heap, idx));
+
+  POS(ih, h) = NOPOS;
+  vec_pushback(&ih->freeh, &h); /* On failure the handle is just not reused */
+
+  size_t last = --heap->vec.sz;
+  ih->hnd.sz--;
+  if (idx != last)
+    resift(heap, ih, idx, AT(heap, last), HND(ih, last));
+}
+
+int iheap_pop(struct iheap *ih, void *dest)
+{
+  if (!ih || vec_empty(&ih->heap.vec))
+    return -1;
+  detach(ih, 0, dest);
   return 0;
-}
\ No newline at end of file
+}
+
+void *iheap_peek(struct iheap *ih)
+{
+  if (!ih)
+    return NULL;
+  return heap_peek(&ih->heap);
+}
+
+static inline int valid(struct iheap *ih, size_t handle)
+{
+  return handle < vec_size(&ih->pos) && POS(ih, handle) != NOPOS;
+}
+
+void *iheap_get(struct iheap *ih, size_t handle)
+{
+  if (!ih || !valid(ih, handle))
+    return NULL;
+  return AT(&ih->heap, POS(ih, handle));
+}
+
+int iheap_update(struct iheap *ih, size_t handle)
+{
+  if (!ih || !valid(ih, handle))
+    return -1;
+  struct heap *heap = &ih->heap;
+  size_t idx = POS(ih, handle);
+  void *tmp = AT(heap, vec_size(&heap->vec));
+  memcpy(tmp, AT(heap, idx), heap->vec.elesz);
+  resift(heap, ih, idx, tmp, handle);
+  return 0;
+}
+
+int iheap_erase(struct iheap *ih, size_t handle, void *dest)
+{
+  if (!ih || !valid(ih, handle))
+    return -1;
+  detach(ih, POS(ih, handle), dest);
+  return 0;
+}
+
+void iheap_clear(struct iheap *ih)
+{
+  if (!ih)
+    return;
+  heap_clear(&ih->heap);
+  vec_clear(&ih->pos);
+  vec_clear(&ih->hnd);
+  vec_clear(&ih->freeh);
+}
@@ -0,0 +1,160 @@
+/* collection - A generic data structure and algorithms library
+ * Copyright (C) 2025 Yixiang Qiu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <mpmcq.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SLOT(q, pos) ((q)->buf + ((pos) & (q)->mask) * (q)->stride)
+#define SEQ(slot) ((atomic_size_t *)(slot))
+#define DATA(slot) ((void *)((slot) + sizeof(atomic_size_t)))
+#define LOADSEQ(q, pos)                                                        \
+  atomic_load_explicit(SEQ(SLOT(q, pos)), memory_order_acquire)
+
+/* Claim up to n consecutive positions from the counter ctr. A slot at pos is
+   ready when its sequence number is pos + off, off is 0 for producers and 1
+   for consumers. Stores the first claimed position in pos and returns the
+   number claimed, 0 when the queue is full (empty for consumers). */
+static size_t claim(struct mpmcq *q, atomic_size_t *ctr, size_t n, size_t off,
+                    size_t *pos);
+
+int mpmcq_init(struct mpmcq *q, size_t elesz, size_t cap,
+               void (*destroy)(void *))
+{
+  if (!q || !elesz || cap > SIZE_MAX / 2 + 1)
+    return -1;
+  size_t align = _Alignof(atomic_size_t);
+  size_t stride = (sizeof(atomic_size_t) + elesz + align - 1) & ~(align - 1);
+  size_t pow = 2;
+  while (pow < cap)
+    pow <<= 1;
+  if (stride < elesz || pow > SIZE_MAX / stride)
+    return -1;
+  q->buf = malloc(pow * stride);
+  if (!q->buf)
+    return -1;
+  q->elesz = elesz;
+  q->stride = stride;
+  q->mask = pow - 1;
+  q->destroy = destroy;
+  for (size_t i = 0; i < pow; i++)
+    atomic_init(SEQ(SLOT(q, i)), i);
+  atomic_init(&q->enq, 0);
+  atomic_init(&q->deq, 0);
+  return 0;
+}
+
+void mpmcq_fini(struct mpmcq *q)
+{
+  if (!q || !q->buf)
+    return;
+  if (q->destroy) {
+    size_t end = atomic_load(&q->enq);
+    for (size_t pos = atomic_load(&q->deq); pos != end; pos++)
+      q->destroy(DATA(SLOT(q, pos)));
+  }
+  free(q->buf);
+  q->buf = NULL;
+}
+
+size_t mpmcq_size(struct mpmcq *q)
+{
+  if (!q)
+    return 0;
+  size_t deq = atomic_load_explicit(&q->deq, memory_order_relaxed);
+  size_t enq = atomic_load_explicit(&q->enq, memory_order_relaxed);
+  size_t sz = enq - deq;
+  if ((intptr_t)sz < 0)
+    return 0;
+  return sz > q->mask + 1 ? q->mask + 1 : sz;
+}
+
+int mpmcq_try_enq(struct mpmcq *q, void *ele)
+{
+  return mpmcq_try_enq_n(q, ele, 1) == 1 ? 0 : -1;
+}
+
+int mpmcq_try_deq(struct mpmcq *q, void *dest)
+{
+  if (!q)
+    return -1;
+  size_t pos;
+  if (!claim(q, &q->deq, 1, 1, &pos))
+    return -1;
+  char *slot = SLOT(q, pos);
+  if (dest)
+    memcpy(dest, DATA(slot), q->elesz);
+  else if (q->destroy)
+    q->destroy(DATA(slot));
+  atomic_store_explicit(SEQ(slot), pos + q->mask + 1, memory_order_release);
+  return 0;
+}
+
+size_t mpmcq_try_enq_n(struct mpmcq *q, void *base, size_t n)
+{
+  if (!q || !base || !n)
+    return 0;
+  size_t pos, m = claim(q, &q->enq, n, 0, &pos);
+  for (size_t i = 0; i < m; i++) {
+    char *slot = SLOT(q, pos + i);
+    memcpy(DATA(slot), (char *)base + i * q->elesz, q->elesz);
+    atomic_store_explicit(SEQ(slot), pos + i + 1, memory_order_release);
+  }
+  return m;
+}
+
+size_t mpmcq_try_deq_n(struct mpmcq *q, void *dest, size_t n)
+{
+  if (!q || !dest || !n)
+    return 0;
+  size_t pos, m = claim(q, &q->deq, n, 1, &pos);
+  for (size_t i = 0; i < m; i++) {
+    char *slot = SLOT(q, pos + i);
+    memcpy((char *)dest + i * q->elesz, DATA(slot), q->elesz);
+    atomic_store_explicit(SEQ(slot), pos + i + q->mask + 1,
+                          memory_order_release);
+  }
+  return m;
+}
+
+static size_t claim(struct mpmcq *q, atomic_size_t *ctr, size_t n, size_t off,
+                    size_t *pos)
+{
+  size_t p = atomic_load_explicit(ctr, memory_order_relaxed);
+  for (;;) {
+    /* A ready slot can only be taken by whoever owns its position, so the
+       whole run stays ready once the CAS below succeeds */
+    size_t m = 0;
+    while (m < n && LOADSEQ(q, p + m) == p + m + off)
+      m++;
+    if (!m) {
+      if ((intptr_t)(LOADSEQ(q, p) - (p + off)) < 0)
+        return 0;
+      p = atomic_load_explicit(ctr, memory_order_relaxed);
+      continue;
+    }
+    if (atomic_compare_exchange_weak_explicit(ctr, &p, p + m,
+                                              memory_order_relaxed,
+                                              memory_order_relaxed)) {
+      *pos = p;
+      return m;
+    }
+  }
+}
@@ -0,0 +1,148 @@
+/* collection - A generic data structure and algorithms library
+ * Copyright (C) 2025 Yixiang Qiu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <radixheap.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector.h>
+
+/* Bucket entries hold the element first so the vector destructor sees it,
+   then the key at an 8-byte aligned offset */
+#define KEYOFF(rh) (((rh)->elesz + 7) & ~(size_t)7)
+#define KEY(rh, ent) (*(uint64_t *)((char *)(ent) + KEYOFF(rh)))
+#define ENTRY(vec, idx) ((void *)((vec)->buf + (idx) * (vec)->elesz))
+
+/* Bucket of a key relative to the last popped key: 0 when equal, otherwise
+   one past the index of the highest differing bit */
+static inline size_t bucket(uint64_t key, uint64_t last)
+{
+  return key == last ? 0 : 64 - __builtin_clzll(key ^ last);
+}
+
+/* Refill bucket 0 from the first non-empty bucket, which then holds the
+   minimum. Requires a non-empty heap, the heap is unchanged on error. */
+static int pull(struct radixheap *rh);
+
+int radixheap_init(struct radixheap *rh, size_t elesz, void (*destroy)(void *))
+{
+  if (!rh || !elesz)
+    return -1;
+  memset(rh, 0, sizeof(struct radixheap));
+  rh->elesz = elesz;
+  size_t stride = KEYOFF(rh) + sizeof(uint64_t);
+  for (size_t i = 0; i < RADIXHEAP_BUCKETS; i++)
+    vec_init(&rh->buckets[i], stride, destroy);
+  return 0;
+}
+
+void radixheap_fini(struct radixheap *rh)
+{
+  if (!rh)
+    return;
+  for (size_t i = 0; i < RADIXHEAP_BUCKETS; i++)
+    vec_fini(&rh->buckets[i]);
+  rh->sz = 0;
+}
+
+int radixheap_push(struct radixheap *rh, uint64_t key, void *ele)
+{
+  if (!rh || !ele || key < rh->last)
+    return -1;
+  struct vector *b = &rh->buckets[bucket(key, rh->last)];
+  if (vec_reserve(b, b->sz + 1) == -1)
+    return -1;
+  void *ent = ENTRY(b, b->sz++);
+  memcpy(ent, ele, rh->elesz);
+  KEY(rh, ent) = key;
+  rh->sz++;
+  return 0;
+}
+
+int radixheap_pop(struct radixheap *rh, uint64_t *key, void *dest)
+{
+  if (!rh || !rh->sz || pull(rh) == -1)
+    return -1;
+  struct vector *b = &rh->buckets[0];
+  void *ent = ENTRY(b, b->sz - 1);
+  if (key)
+    *key = KEY(rh, ent);
+  if (dest)
+    memcpy(dest, ent, rh->elesz);
+  else if (b->destroy)
+    b->destroy(ent);
+  b->sz--;
+  rh->sz--;
+  return 0;
+}
+
+void *radixheap_peek(struct radixheap *rh, uint64_t *key)
+{
+  if (!rh || !rh->sz || pull(rh) == -1)
+    return NULL;
+  struct vector *b = &rh->buckets[0];
+  void *ent = ENTRY(b, b->sz - 1);
+  if (key)
+    *key = KEY(rh, ent);
+  return ent;
+}
+
+void radixheap_clear(struct radixheap *rh)
+{
+  if (!rh)
+    return;
+  for (size_t i = 0; i < RADIXHEAP_BUCKETS; i++)
+    vec_clear(&rh->buckets[i]);
+  rh->sz = 0;
+}
+
+static int pull(struct radixheap *rh)
+{
+  if (!vec_empty(&rh->buckets[0]))
+    return 0;
+  size_t i = 1;
+  while (vec_empty(&rh->buckets[i]))
+    i++;
+
+  struct vector *b = &rh->buckets[i];
+  uint64_t min = UINT64_MAX;
+  for (size_t j = 0; j < b->sz; j++) {
+    uint64_t k = KEY(rh, ENTRY(b, j));
+    if (k < min)
+      min = k;
+  }
+
+  /* Every entry lands in a lower bucket, make room in all of them first so a
+     failed allocation leaves the heap untouched */
+  size_t cnt[RADIXHEAP_BUCKETS] = {0};
+  for (size_t j = 0; j < b->sz; j++)
+    cnt[bucket(KEY(rh, ENTRY(b, j)), min)]++;
+  for (size_t t = 0; t < i; t++) {
+    struct vector *to = &rh->buckets[t];
+    if (cnt[t] && vec_reserve(to, to->sz + cnt[t]) == -1)
+      return -1;
+  }
+
+  rh->last = min;
+  for (size_t j = 0; j < b->sz; j++) {
+    void *ent = ENTRY(b, j);
+    struct vector *to = &rh->buckets[bucket(KEY(rh, ent), min)];
+    memcpy(ENTRY(to, to->sz++), ent, b->elesz);
+  }
+  b->sz = 0;
+  return 0;
+}
@@ -0,0 +1,84 @@
+/* collection - A generic data structure and algorithms library
+ * Copyright (C) 2025 Yixiang Qiu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <deque.h>
+#include <ring.h>
+#include <stddef.h>
+
+int ring_init(struct ring *ring, size_t elesz, size_t cap,
+              void (*destroy)(void *))
+{
+  if (!ring || !elesz || !cap)
+    return -1;
+  if (deq_init(&ring->deq, elesz, destroy) == -1)
+    return -1;
+  /* Allocate the whole buffer now, the size never exceeds cap afterwards so
+     the deque never grows again */
+  if (deq_reserve(&ring->deq, cap) == -1) {
+    deq_fini(&ring->deq);
+    return -1;
+  }
+  ring->cap = cap;
+  return 0;
+}
+
+void ring_fini(struct ring *ring)
+{
+  if (!ring)
+    return;
+  deq_fini(&ring->deq);
+}
+
+void *ring_at(const struct ring *ring, size_t idx)
+{
+  if (!ring)
+    return NULL;
+  return deq_at(&ring->deq, idx);
+}
+
+int ring_push(struct ring *ring, void *ele, void *evicted)
+{
+  if (!ring || !ele)
+    return -1;
+  int full = ring_full(ring);
+  if (full)
+    deq_popfront(&ring->deq, evicted);
+  deq_pushback(&ring->deq, ele);
+  return full;
+}
+
+int ring_pop(struct ring *ring, void *dest)
+{
+  if (!ring)
+    return -1;
+  return deq_popfront(&ring->deq, dest);
+}
+
+int ring_spans(const struct ring *ring, void **a, size_t *alen, void **b,
+               size_t *blen)
+{
+  if (!ring)
+    return -1;
+  return deq_spans(&ring->deq, a, alen, b, blen);
+}
+
+void ring_clear(struct ring *ring)
+{
+  if (!ring)
+    return;
+  deq_clear(&ring->deq);
+}
@@ -0,0 +1,227 @@
+/* collection - A generic data structure and algorithms library
+ * Copyright (C) 2025 Yixiang Qiu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <errno.h>
+#include <segdeq.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BLOCKSZ 512 /* Target bytes per block */
+#define MINBLOCK 16 /* Minimum elements per block */
+#define MINMAP 8
+
+#define BLOCKN(dq) ((size_t)1 << (dq)->shift) /* Elements per block */
+#define GPOS(dq, gidx)                                                         \
+  ((void *)((dq)->map[(dq)->mfirst + ((gidx) >> (dq)->shift)] +                \
+            ((gidx) & (BLOCKN(dq) - 1)) * (dq)->elesz)) /* Get the element */
+
+/* Take the spare block or allocate a new one */
+static char *newblock(struct segdeq *dq);
+
+/* Keep the block as the spare or free it */
+static void dropblock(struct segdeq *dq, char *blk);
+
+/* Make sure there is a free map slot before the front block (front != 0) or
+   after the back block, only block pointers are moved */
+static int reserve(struct segdeq *dq, int front);
+
+/* Release the blocks of an empty deque and recenter it in the map */
+static void reset(struct segdeq *dq);
+
+int segdeq_init(struct segdeq *dq, size_t elesz, void (*destroy)(void *))
+{
+  if (!dq || !elesz)
+    return -1;
+  memset(dq, 0, sizeof(struct segdeq));
+  size_t n = MINBLOCK;
+  dq->shift = 4;
+  while (elesz <= BLOCKSZ / (n * 2)) {
+    n *= 2;
+    dq->shift++;
+  }
+  if (elesz > SIZE_MAX / n) {
+    errno = ERANGE;
+    return -1;
+  }
+  dq->elesz = elesz;
+  dq->destroy = destroy;
+  return 0;
+}
+
+void segdeq_fini(struct segdeq *dq)
+{
+  if (!dq)
+    return;
+  segdeq_clear(dq);
+  free(dq->spare);
+  free(dq->map);
+  dq->spare = NULL;
+  dq->map = NULL;
+  dq->mapcap = 0;
+}
+
+void *segdeq_at(const struct segdeq *dq, size_t idx)
+{
+  if (!dq || idx >= dq->sz)
+    return NULL;
+  return GPOS(dq, dq->off + idx);
+}
+
+int segdeq_pushback(struct segdeq *dq, void *ele)
+{
+  if (!dq || !ele)
+    return -1;
+  size_t gidx = dq->off + dq->sz;
+  if (gidx == dq->nblk << dq->shift) {
+    if (reserve(dq, 0) == -1)
+      return -1;
+    char *blk = newblock(dq);
+    if (!blk)
+      return -1;
+    dq->map[dq->mfirst + dq->nblk++] = blk;
+  }
+  memcpy(GPOS(dq, gidx), ele, dq->elesz);
+  dq->sz++;
+  return 0;
+}
+
+int segdeq_pushfront(struct segdeq *dq, void *ele)
+{
+  if (!dq || !ele)
+    return -1;
+  if (dq->off == 0) {
+    if (reserve(dq, 1) == -1)
+      return -1;
+    char *blk = newblock(dq);
+    if (!blk)
+      return -1;
+    dq->map[--dq->mfirst] = blk;
+    dq->nblk++;
+    dq->off = BLOCKN(dq);
+  }
+  dq->off--;
+  memcpy(GPOS(dq, dq->off), ele, dq->elesz);
+  dq->sz++;
+  return 0;
+}
+
+int segdeq_popback(struct segdeq *dq, void *dest)
+{
+  if (!dq || segdeq_empty(dq))
+    return -1;
+  void *ele = GPOS(dq, dq->off + dq->sz - 1);
+  if (dest)
+    memcpy(dest, ele, dq->elesz);
+  else if (dq->destroy)
+    dq->destroy(ele);
+  dq->sz--;
+  if (!dq->sz)
+    reset(dq);
+  else if (dq->off + dq->sz <= (dq->nblk - 1) << dq->shift)
+    dropblock(dq, dq->map[dq->mfirst + --dq->nblk]);
+  return 0;
+}
+
+int segdeq_popfront(struct segdeq *dq, void *dest)
+{
+  if (!dq || segdeq_empty(dq))
+    return -1;
+  void *ele = GPOS(dq, dq->off);
+  if (dest)
+    memcpy(dest, ele, dq->elesz);
+  else if (dq->destroy)
+    dq->destroy(ele);
+  dq->off++;
+  dq->sz--;
+  if (!dq->sz)
+    reset(dq);
+  else if (dq->off == BLOCKN(dq)) {
+    dropblock(dq, dq->map[dq->mfirst++]);
+    dq->nblk--;
+    dq->off = 0;
+  }
+  return 0;
+}
+
+void segdeq_clear(struct segdeq *dq)
+{
+  if (!dq)
+    return;
+  if (dq->destroy)
+    for (size_t i = 0; i < dq->sz; i++)
+      dq->destroy(GPOS(dq, dq->off + i));
+  dq->sz = 0;
+  reset(dq);
+}
+
+static char *newblock(struct segdeq *dq)
+{
+  char *blk = dq->spare;
+  if (blk)
+    dq->spare = NULL;
+  else
+    blk = malloc(dq->elesz << dq->shift);
+  return blk;
+}
+
+static void dropblock(struct segdeq *dq, char *blk)
+{
+  if (!dq->spare)
+    dq->spare = blk;
+  else
+    free(blk);
+}
+
+static int reserve(struct segdeq *dq, int front)
+{
+  if (front ? dq->mfirst > 0 : dq->mfirst + dq->nblk < dq->mapcap)
+    return 0;
+  /* Recenter when at least half the map is free, otherwise double it */
+  if (dq->mapcap && dq->nblk * 2 <= dq->mapcap) {
+    size_t first = (dq->mapcap - dq->nblk) / 2;
+    memmove(dq->map + first, dq->map + dq->mfirst, dq->nblk * sizeof(char *));
+    dq->mfirst = first;
+    return 0;
+  }
+  size_t newcap = dq->mapcap ? dq->mapcap * 2 : MINMAP;
+  if (newcap > SIZE_MAX / sizeof(char *)) {
+    errno = ERANGE;
+    return -1;
+  }
+  char **newmap = malloc(newcap * sizeof(char *));
+  if (!newmap)
+    return -1;
+  size_t first = (newcap - dq->nblk) / 2;
+  if (dq->nblk)
+    memcpy(newmap + first, dq->map + dq->mfirst, dq->nblk * sizeof(char *));
+  free(dq->map);
+  dq->map = newmap;
+  dq->mapcap = newcap;
+  dq->mfirst = first;
+  return 0;
+}
+
+static void reset(struct segdeq *dq)
+{
+  for (size_t i = 0; i < dq->nblk; i++)
+    dropblock(dq, dq->map[dq->mfirst + i]);
+  dq->nblk = 0;
+  dq->off = 0;
+  dq->mfirst = dq->mapcap / 2;
+}
@@ -0,0 +1,478 @@
+/* collection - A generic data structure and algorithms library
+ * Copyright (C) 2025 Yixiang Qiu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <skiplist.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define MARKED(p) ((p) & 1)
+#define NODE(p) ((struct skiplist_node *)((p) & ~(uintptr_t)1))
+#define LOADNEXT(node, l) atomic_load(&(node)->next[l])
+
+/* Node state bits, the second of inserter and remover to finish retires */
+#define INSERTED 1
+#define REMOVED 2
+
+/* Retired nodes a slot collects before it tries to advance the epoch and free
+   what is old enough */
+#define RECLAIM 64
+
+/* Hint to the CPU that we are busy waiting */
+static inline void relax(void);
+
+/* Per-thread random stream for node heights, seeded from a thread-local
+   address so threads do not share it */
+static int randheight(void);
+
+static struct skiplist_node *create_node(void *key, void *val, int height);
+
+/* Destroy the key and, unless the remover took it, the value of a node and
+   free it */
+static void destroy_node(struct skiplist_fns *fns, struct skiplist_node *node);
+
+/* Take an idle slot and announce the current epoch in it, returns the slot */
+static size_t pin(struct skiplist *sl);
+static void unpin(struct skiplist *sl, size_t slot);
+
+/* Queue an unlinked node on the slot, and every RECLAIM nodes try to advance
+   the epoch and free the nodes retired two epochs ago */
+static void retire(struct skiplist *sl, size_t slot,
+                   struct skiplist_node *node);
+
+/* Fill preds and succs with the nodes around key on every level, unlinking
+   marked nodes on the way. Returns 1 if succs[0] holds key. */
+static int search(struct skiplist *sl, void *key,
+                  struct skiplist_node **preds, struct skiplist_node **succs);
+
+/* First unmarked node with a key not less than key, without unlinking */
+static struct skiplist_node *lower_bound(struct skiplist *sl, void *key);
+
+/* Set the state bit of whoever finished with node. The second one unlinks
+   node from every level it may still be on and retires it. */
+static void finish(struct skiplist *sl, size_t slot, void *key,
+                   struct skiplist_node *node, int bit);
+
+int skiplist_init(struct skiplist *sl, struct skiplist_fns *fns)
+{
+  if (!sl || !fns || !fns->cmp)
+    return -1;
+  sl->head = create_node(NULL, NULL, SKIPLIST_MAXLEVEL);
+  sl->slots = aligned_alloc(_Alignof(struct skiplist_slot),
+                            SKIPLIST_NSLOT * sizeof(struct skiplist_slot));
+  if (!sl->head || !sl->slots) {
+    free(sl->head);
+    free(sl->slots);
+    return -1;
+  }
+  for (size_t i = 0; i < SKIPLIST_NSLOT; i++) {
+    atomic_init(&sl->slots[i].state, 0);
+    sl->slots[i].limbo = NULL;
+    sl->slots[i].nlimbo = 0;
+  }
+  sl->fns = fns;
+  atomic_init(&sl->epoch, 0);
+  atomic_init(&sl->size, 0);
+  return 0;
+}
+
+void skiplist_fini(struct skiplist *sl)
+{
+  if (!sl || !sl->head)
+    return;
+  struct skiplist_node *node = NODE(LOADNEXT(sl->head, 0)), *next;
+  for (; node; node = next) {
+    next = NODE(LOADNEXT(node, 0));
+    destroy_node(sl->fns, node);
+  }
+  for (size_t i = 0; i < SKIPLIST_NSLOT; i++) {
+    for (node = sl->slots[i].limbo; node; node = next) {
+      next = node->retired;
+      destroy_node(sl->fns, node);
+    }
+  }
+  free(sl->head);
+  free(sl->slots);
+  sl->head = NULL;
+  sl->slots = NULL;
+  atomic_store(&sl->size, 0);
+}
+
+size_t skiplist_size(struct skiplist *sl)
+{
+  if (!sl)
+    return 0;
+  return atomic_load_explicit(&sl->size, memory_order_relaxed);
+}
+
+int skiplist_insert(struct skiplist *sl, void *key, void *val)
+{
+  if (!sl || !key)
+    return -1;
+  struct skiplist_node *preds[SKIPLIST_MAXLEVEL], *succs[SKIPLIST_MAXLEVEL];
+  struct skiplist_node *node = create_node(key, val, randheight());
+  if (!node)
+    return -1;
+  size_t slot = pin(sl);
+
+  /* Count the node before it is published, a remover can only decrement after
+     finding it, so the size never drops below zero. A duplicate backs out. */
+  atomic_fetch_add_explicit(&sl->size, 1, memory_order_relaxed);
+
+  /* The node becomes part of the list once it is linked on level 0 */
+  for (;;) {
+    if (search(sl, key, preds, succs)) {
+      atomic_fetch_sub_explicit(&sl->size, 1, memory_order_relaxed);
+      unpin(sl, slot);
+      free(node);
+      return -1;
+    }
+    for (int l = 0; l < node->height; l++)
+      atomic_store_explicit(&node->next[l], (uintptr_t)succs[l],
+                            memory_order_relaxed);
+    uintptr_t expect = (uintptr_t)succs[0];
+    if (atomic_compare_exchange_strong(&preds[0]->next[0], &expect,
+                                       (uintptr_t)node))
+      break;
+  }
+
+  /* Link the upper levels, giving up as soon as a remover marks the node */
+  for (int l = 1; l < node->height; l++) {
+    for (;;) {
+      uintptr_t next = LOADNEXT(node, l);
+      if (MARKED(next))
+        goto done;
+      if (NODE(next) != succs[l] &&
+          !atomic_compare_exchange_strong(&node->next[l], &next,
+                                          (uintptr_t)succs[l]))
+        goto done;
+      uintptr_t expect = (uintptr_t)succs[l];
+      if (atomic_compare_exchange_strong(&preds[l]->next[l], &expect,
+                                         (uintptr_t)node))
+        break;
+      if (!search(sl, key, preds, succs) || succs[0] != node)
+        goto done;
+    }
+  }
+done:
+  finish(sl, slot, key, node, INSERTED);
+  unpin(sl, slot);
+  return 0;
+}
+
+int skiplist_remove(struct skiplist *sl, void *key, void **dest)
+{
+  if (!sl || !key)
+    return -1;
+  struct skiplist_node *preds[SKIPLIST_MAXLEVEL], *succs[SKIPLIST_MAXLEVEL];
+  size_t slot = pin(sl);
+
+  if (!search(sl, key, preds, succs)) {
+    unpin(sl, slot);
+    return -1;
+  }
+  struct skiplist_node *node = succs[0];
+  /* Mark top down, the level 0 mark decides which remover wins */
+  for (int l = node->height - 1; l > 0; l--) {
+    uintptr_t next = LOADNEXT(node, l);
+    while (!MARKED(next) &&
+           !atomic_compare_exchange_weak(&node->next[l], &next, next | 1))
+      ;
+  }
+  uintptr_t next = LOADNEXT(node, 0);
+  for (;;) {
+    if (MARKED(next)) {
+      unpin(sl, slot);
+      return -1;
+    }
+    if (atomic_compare_exchange_weak(&node->next[0], &next, next | 1))
+      break;
+  }
+  atomic_fetch_sub_explicit(&sl->size, 1, memory_order_relaxed);
+  if (dest) {
+    *dest = node->val;
+    node->ownval = 1;
+  }
+  finish(sl, slot, key, node, REMOVED);
+  unpin(sl, slot);
+  return 0;
+}
+
+void *skiplist_find(struct skiplist *sl, void *key)
+{
+  if (!sl || !key)
+    return NULL;
+  size_t slot = pin(sl);
+  struct skiplist_node *node = lower_bound(sl, key);
+  void *val = NULL;
+  if (node && sl->fns->cmp(node->key, key) == 0)
+    val = node->val;
+  unpin(sl, slot);
+  return val;
+}
+
+int skiplist_contains(struct skiplist *sl, void *key)
+{
+  if (!sl || !key)
+    return 0;
+  size_t slot = pin(sl);
+  struct skiplist_node *node = lower_bound(sl, key);
+  int found = node && sl->fns->cmp(node->key, key) == 0;
+  unpin(sl, slot);
+  return found;
+}
+
+int skiplist_iter_init(struct skiplist_iter *iter, struct skiplist *sl)
+{
+  if (!iter || !sl)
+    return -1;
+  iter->sl = sl;
+  iter->slot = pin(sl);
+  iter->node = sl->head;
+  skiplist_iter_inc(iter);
+  return 0;
+}
+
+int skiplist_iter_seek(struct skiplist_iter *iter, struct skiplist *sl,
+                       void *key)
+{
+  if (!iter || !sl || !key)
+    return -1;
+  iter->sl = sl;
+  iter->slot = pin(sl);
+  iter->node = lower_bound(sl, key);
+  return 0;
+}
+
+void skiplist_iter_inc(struct skiplist_iter *iter)
+{
+  if (!iter || !iter->node)
+    return;
+  /* A removed node still points forward, skip over any marked ones */
+  struct skiplist_node *node = NODE(LOADNEXT(iter->node, 0));
+  while (node && MARKED(LOADNEXT(node, 0)))
+    node = NODE(LOADNEXT(node, 0));
+  iter->node = node;
+}
+
+int skiplist_iter_get(struct skiplist_iter *iter, void **key, void **val)
+{
+  if (!iter || !iter->node)
+    return -1;
+  if (key)
+    *key = iter->node->key;
+  if (val)
+    *val = iter->node->val;
+  return 0;
+}
+
+void skiplist_iter_fini(struct skiplist_iter *iter)
+{
+  if (!iter || !iter->sl)
+    return;
+  unpin(iter->sl, iter->slot);
+  iter->sl = NULL;
+  iter->node = NULL;
+}
+
+static inline void relax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  __asm__ __volatile__("yield");
+#endif
+}
+
+static int randheight(void)
+{
+  static _Thread_local uint32_t seed;
+  if (!seed)
+    seed = (uint32_t)((uintptr_t)&seed >> 4) | 1;
+  seed ^= seed << 13;
+  seed ^= seed >> 17;
+  seed ^= seed << 5;
+  uint32_t r = seed;
+  int height = 1;
+  while (height < SKIPLIST_MAXLEVEL && !(r & 3)) {
+    height++;
+    r >>= 2;
+  }
+  return height;
+}
+
+static struct skiplist_node *create_node(void *key, void *val, int height)
+{
+  struct skiplist_node *node =
+      malloc(sizeof(struct skiplist_node) + height * sizeof(uintptr_t));
+  if (!node)
+    return NULL;
+  node->key = key;
+  node->val = val;
+  node->retired = NULL;
+  node->epoch = 0;
+  atomic_init(&node->state, 0);
+  node->ownval = 0;
+  node->height = height;
+  for (int l = 0; l < height; l++)
+    atomic_init(&node->next[l], 0);
+  return node;
+}
+
+static void destroy_node(struct skiplist_fns *fns, struct skiplist_node *node)
+{
+  if (fns->destroy_key)
+    fns->destroy_key(node->key);
+  if (!node->ownval && fns->destroy_val)
+    fns->destroy_val(node->val);
+  free(node);
+}
+
+static size_t pin(struct skiplist *sl)
+{
+  static _Thread_local size_t hint = SIZE_MAX;
+  if (hint == SIZE_MAX)
+    hint = ((uintptr_t)&hint >> 6) % SKIPLIST_NSLOT;
+  size_t i = hint, epoch = atomic_load(&sl->epoch);
+
+  for (;;) {
+    size_t idle = 0;
+    if (atomic_compare_exchange_strong(&sl->slots[i].state, &idle,
+                                       epoch << 1 | 1))
+      break;
+    i = (i + 1) % SKIPLIST_NSLOT;
+    if (i == hint)
+      relax();
+  }
+  /* The epoch may have advanced before the announcement became visible,
+     announce again until it is current */
+  for (;;) {
+    size_t now = atomic_load(&sl->epoch);
+    if (now == epoch)
+      break;
+    epoch = now;
+    atomic_store(&sl->slots[i].state, epoch << 1 | 1);
+  }
+  hint = i;
+  return i;
+}
+
+static void unpin(struct skiplist *sl, size_t slot)
+{
+  atomic_store_explicit(&sl->slots[slot].state, 0, memory_order_release);
+}
+
+static void retire(struct skiplist *sl, size_t slot,
+                   struct skiplist_node *node)
+{
+  struct skiplist_slot *s = &sl->slots[slot];
+  size_t epoch = atomic_load(&sl->epoch);
+
+  node->epoch = epoch;
+  node->retired = s->limbo;
+  s->limbo = node;
+  /* Try again only every RECLAIM retires, while a stalled operation holds the
+     epoch back each attempt would rescan every slot and the whole list */
+  if (++s->nlimbo % RECLAIM)
+    return;
+
+  /* Advance only if every operation in progress started in this epoch */
+  size_t i;
+  for (i = 0; i < SKIPLIST_NSLOT; i++) {
+    size_t state = atomic_load(&sl->slots[i].state);
+    if ((state & 1) && state >> 1 != epoch)
+      break;
+  }
+  if (i == SKIPLIST_NSLOT &&
+      atomic_compare_exchange_strong(&sl->epoch, &epoch, epoch + 1))
+    epoch++;
+
+  /* The list is newest first and its epochs never increase, so everything
+     from the first node old enough onwards can go */
+  struct skiplist_node **link = &s->limbo;
+  while (*link && (*link)->epoch + 2 > epoch)
+    link = &(*link)->retired;
+  struct skiplist_node *old = *link, *next;
+  *link = NULL;
+  for (; old; old = next) {
+    next = old->retired;
+    destroy_node(sl->fns, old);
+    s->nlimbo--;
+  }
+}
+
+static int search(struct skiplist *sl, void *key,
+                  struct skiplist_node **preds, struct skiplist_node **succs)
+{
+retry:;
+  struct skiplist_node *pred = sl->head;
+  for (int l = SKIPLIST_MAXLEVEL - 1; l >= 0; l--) {
+    struct skiplist_node *curr = NODE(LOADNEXT(pred, l));
+    while (curr) {
+      uintptr_t next = LOADNEXT(curr, l);
+      if (MARKED(next)) {
+        uintptr_t expect = (uintptr_t)curr;
+        if (!atomic_compare_exchange_strong(&pred->next[l], &expect,
+                                            (uintptr_t)NODE(next)))
+          goto retry;
+        curr = NODE(next);
+        continue;
+      }
+      if (sl->fns->cmp(curr->key, key) >= 0)
+        break;
+      pred = curr;
+      curr = NODE(next);
+    }
+    preds[l] = pred;
+    succs[l] = curr;
+  }
+  return succs[0] && sl->fns->cmp(succs[0]->key, key) == 0;
+}
+
+static struct skiplist_node *lower_bound(struct skiplist *sl, void *key)
+{
+  struct skiplist_node *pred = sl->head, *curr = NULL;
+  for (int l = SKIPLIST_MAXLEVEL - 1; l >= 0; l--) {
+    curr = NODE(LOADNEXT(pred, l));
+    while (curr) {
+      uintptr_t next = LOADNEXT(curr, l);
+      if (!MARKED(next) && sl->fns->cmp(curr->key, key) >= 0)
+        break;
+      /* A marked node is passed over whatever its key, its next pointer
+         still leads forward */
+      if (!MARKED(next))
+        pred = curr;
+      curr = NODE(next);
+    }
+  }
+  while (curr && MARKED(LOADNEXT(curr, 0)))
+    curr = NODE(LOADNEXT(curr, 0));
+  return curr;
+}
+
+static void finish(struct skiplist *sl, size_t slot, void *key,
+                   struct skiplist_node *node, int bit)
+{
+  struct skiplist_node *preds[SKIPLIST_MAXLEVEL], *succs[SKIPLIST_MAXLEVEL];
+  if (atomic_fetch_or(&node->state, bit) != (INSERTED | REMOVED) - bit)
+    return;
+  /* Every level the node is on is marked now, so a search for its key
+     unlinks it everywhere */
+  search(sl, key, preds, succs);
+  retire(sl, slot, node);
+}
@@ -0,0 +1,177 @@
+/* collection - A generic data structure and algorithms library
+ * Copyright (C) 2025 Yixiang Qiu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <spscq.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SLOT(q, pos) ((q)->buf + ((pos) & (q)->mask) * (q)->elesz)
+
+/* Free slots seen by the producer at tail, refreshing the cached head only
+   when fewer than n are known to be free */
+static size_t space(struct spscq *q, size_t tail, size_t n);
+
+/* Filled slots seen by the consumer at head, refreshing the cached tail only
+   when fewer than n are known to be filled */
+static size_t filled(struct spscq *q, size_t head, size_t n);
+
+/* Copy n elements between the ring at pos and the flat buffer flat, in two
+   pieces when the span wraps around */
+static void copyin(struct spscq *q, size_t pos, const void *flat, size_t n);
+static void copyout(struct spscq *q, size_t pos, void *flat, size_t n);
+
+int spscq_init(struct spscq *q, size_t elesz, size_t cap,
+               void (*destroy)(void *))
+{
+  if (!q || !elesz || cap > SIZE_MAX / 2 + 1)
+    return -1;
+  size_t pow = 1;
+  while (pow < cap)
+    pow <<= 1;
+  if (pow > SIZE_MAX / elesz)
+    return -1;
+  q->buf = malloc(pow * elesz);
+  if (!q->buf)
+    return -1;
+  q->elesz = elesz;
+  q->mask = pow - 1;
+  q->destroy = destroy;
+  q->tailcache = q->headcache = 0;
+  atomic_init(&q->head, 0);
+  atomic_init(&q->tail, 0);
+  return 0;
+}
+
+void spscq_fini(struct spscq *q)
+{
+  if (!q || !q->buf)
+    return;
+  if (q->destroy) {
+    size_t end = atomic_load(&q->tail);
+    for (size_t pos = atomic_load(&q->head); pos != end; pos++)
+      q->destroy(SLOT(q, pos));
+  }
+  free(q->buf);
+  q->buf = NULL;
+}
+
+size_t spscq_size(struct spscq *q)
+{
+  if (!q)
+    return 0;
+  size_t head = atomic_load_explicit(&q->head, memory_order_acquire);
+  return atomic_load_explicit(&q->tail, memory_order_acquire) - head;
+}
+
+int spscq_enq(struct spscq *q, void *ele)
+{
+  if (!q || !ele)
+    return -1;
+  size_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+  if (!space(q, tail, 1))
+    return -1;
+  memcpy(SLOT(q, tail), ele, q->elesz);
+  atomic_store_explicit(&q->tail, tail + 1, memory_order_release);
+  return 0;
+}
+
+int spscq_deq(struct spscq *q, void *dest)
+{
+  if (!q)
+    return -1;
+  size_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+  if (!filled(q, head, 1))
+    return -1;
+  if (dest)
+    memcpy(dest, SLOT(q, head), q->elesz);
+  else if (q->destroy)
+    q->destroy(SLOT(q, head));
+  atomic_store_explicit(&q->head, head + 1, memory_order_release);
+  return 0;
+}
+
+size_t spscq_enq_n(struct spscq *q, void *base, size_t n)
+{
+  if (!q || !base)
+    return 0;
+  size_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+  size_t m = space(q, tail, n);
+  if (m > n)
+    m = n;
+  if (!m)
+    return 0;
+  copyin(q, tail, base, m);
+  atomic_store_explicit(&q->tail, tail + m, memory_order_release);
+  return m;
+}
+
+size_t spscq_deq_n(struct spscq *q, void *dest, size_t n)
+{
+  if (!q || !dest)
+    return 0;
+  size_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+  size_t m = filled(q, head, n);
+  if (m > n)
+    m = n;
+  if (!m)
+    return 0;
+  copyout(q, head, dest, m);
+  atomic_store_explicit(&q->head, head + m, memory_order_release);
+  return m;
+}
+
+static size_t space(struct spscq *q, size_t tail, size_t n)
+{
+  size_t room = q->mask + 1 - (tail - q->headcache);
+  if (room < n) {
+    q->headcache = atomic_load_explicit(&q->head, memory_order_acquire);
+    room = q->mask + 1 - (tail - q->headcache);
+  }
+  return room;
+}
+
+static size_t filled(struct spscq *q, size_t head, size_t n)
+{
+  size_t used = q->tailcache - head;
+  if (used < n) {
+    q->tailcache = atomic_load_explicit(&q->tail, memory_order_acquire);
+    used = q->tailcache - head;
+  }
+  return used;
+}
+
+static void copyin(struct spscq *q, size_t pos, const void *flat, size_t n)
+{
+  size_t off = pos & q->mask, first = q->mask + 1 - off;
+  if (first > n)
+    first = n;
+  memcpy(q->buf + off * q->elesz, flat, first * q->elesz);
+  memcpy(q->buf, (const char *)flat + first * q->elesz,
+         (n - first) * q->elesz);
+}
+
+static void copyout(struct spscq *q, size_t pos, void *flat, size_t n)
+{
+  size_t off = pos & q->mask, first = q->mask + 1 - off;
+  if (first > n)
+    first = n;
+  memcpy(flat, q->buf + off * q->elesz, first * q->elesz);
+  memcpy((char *)flat + first * q->elesz, q->buf, (n - first) * q->elesz);
+}
@@ -105,6 +105,24 @@ int vec_resize(struct vector *vec, size_t newsz)
   }
 }
 
+int vec_reserve(struct vector *vec, size_t n)
+{
+  if (!vec)
+    return -1;
+  if (n <= vec->cap)
+    return 0;
+  size_t newcap = vec->cap ? vec->cap * GROWFACTOR : MINCAP;
+  if (newcap < n || newcap < vec->cap)
+    newcap = n;
+  overflowcheck(vec->elesz, newcap);
+  void *newbuf = realloc(vec->buf, newcap * vec->elesz);
+  if (!newbuf)
+    return -1;
+  vec->buf = newbuf;
+  vec->cap = newcap;
+  return 0;
+}
+
 int vec_shrink(struct vector *vec)
 {
   if (!vec)
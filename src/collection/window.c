@@ -0,0 +1,198 @@
+/* collection - A generic data structure and algorithms library
+ * Copyright (C) 2025 Yixiang Qiu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <deque.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <window.h>
+
+/* Round an element size up so the field after it is suitably aligned */
+#define ALIGNUP(n)                                                             \
+  (((n) + _Alignof(max_align_t) - 1) & ~(_Alignof(max_align_t) - 1))
+
+#define SEQ(w, ent) (*(size_t *)((char *)(ent) + (w)->seqoff))
+#define VAL(w, idx) deq_at(&(w)->deq, (idx))
+#define AGG(w, idx) ((char *)deq_at(&(w)->deq, (idx)) + (w)->aggoff)
+
+/* Move the whole back stack to the front stack, filling in the suffix
+   aggregates from the newest entry to the oldest */
+static void flip(struct winagg *w);
+
+int winmono_init(struct winmono *w, size_t elesz, int (*cmp)(void *, void *))
+{
+  if (!w || !elesz || !cmp)
+    return -1;
+  size_t seqoff = ALIGNUP(elesz);
+  if (seqoff < elesz || seqoff > SIZE_MAX - sizeof(size_t)) {
+    errno = ERANGE;
+    return -1;
+  }
+  if (deq_init(&w->deq, seqoff + sizeof(size_t), NULL) == -1)
+    return -1;
+  w->cmp = cmp;
+  w->elesz = elesz;
+  w->seqoff = seqoff;
+  w->lo = w->hi = 0;
+  return 0;
+}
+
+void winmono_fini(struct winmono *w)
+{
+  if (!w)
+    return;
+  deq_fini(&w->deq);
+}
+
+int winmono_push(struct winmono *w, void *ele)
+{
+  if (!w || !ele)
+    return -1;
+  /* Reserve the slot first so a failed allocation loses no candidate */
+  if (deq_reserve(&w->deq, deq_size(&w->deq) + 1) == -1)
+    return -1;
+  /* Candidates that are not better than the new element can never be the
+     answer again, the new element outlives them */
+  while (!deq_empty(&w->deq) && w->cmp(deq_back(&w->deq), ele) >= 0)
+    deq_popback(&w->deq, NULL);
+  deq_resize(&w->deq, deq_size(&w->deq) + 1);
+  void *ent = deq_back(&w->deq);
+  memcpy(ent, ele, w->elesz);
+  SEQ(w, ent) = w->hi++;
+  return 0;
+}
+
+int winmono_evict(struct winmono *w)
+{
+  if (!w || winmono_empty(w))
+    return -1;
+  if (SEQ(w, deq_front(&w->deq)) == w->lo)
+    deq_popfront(&w->deq, NULL);
+  w->lo++;
+  return 0;
+}
+
+void *winmono_query(struct winmono *w)
+{
+  if (!w || winmono_empty(w))
+    return NULL;
+  return deq_front(&w->deq);
+}
+
+void winmono_clear(struct winmono *w)
+{
+  if (!w)
+    return;
+  deq_clear(&w->deq);
+  w->lo = w->hi;
+}
+
+int winagg_init(struct winagg *w, size_t elesz,
+                void (*op)(void *, void *, void *))
+{
+  if (!w || !elesz || !op)
+    return -1;
+  size_t aggoff = ALIGNUP(elesz);
+  if (aggoff < elesz || aggoff > SIZE_MAX / 2) {
+    errno = ERANGE;
+    return -1;
+  }
+  w->backagg = malloc(2 * aggoff);
+  if (!w->backagg)
+    return -1;
+  if (deq_init(&w->deq, 2 * aggoff, NULL) == -1) {
+    free(w->backagg);
+    return -1;
+  }
+  w->tmp = w->backagg + aggoff;
+  w->op = op;
+  w->elesz = elesz;
+  w->aggoff = aggoff;
+  w->nfront = 0;
+  return 0;
+}
+
+void winagg_fini(struct winagg *w)
+{
+  if (!w)
+    return;
+  deq_fini(&w->deq);
+  free(w->backagg);
+  w->backagg = w->tmp = NULL;
+}
+
+int winagg_push(struct winagg *w, void *ele)
+{
+  if (!w || !ele)
+    return -1;
+  size_t n = deq_size(&w->deq);
+  if (deq_resize(&w->deq, n + 1) == -1)
+    return -1;
+  memcpy(VAL(w, n), ele, w->elesz);
+  if (n == w->nfront)
+    memcpy(w->backagg, ele, w->elesz);
+  else {
+    w->op(w->tmp, w->backagg, ele);
+    memcpy(w->backagg, w->tmp, w->elesz);
+  }
+  return 0;
+}
+
+int winagg_evict(struct winagg *w, void *dest)
+{
+  if (!w || winagg_empty(w))
+    return -1;
+  if (!w->nfront)
+    flip(w);
+  if (dest)
+    memcpy(dest, VAL(w, 0), w->elesz);
+  deq_popfront(&w->deq, NULL);
+  w->nfront--;
+  return 0;
+}
+
+int winagg_query(struct winagg *w, void *dest)
+{
+  if (!w || !dest || winagg_empty(w))
+    return -1;
+  if (!w->nfront)
+    memcpy(dest, w->backagg, w->elesz);
+  else if (w->nfront == deq_size(&w->deq))
+    memcpy(dest, AGG(w, 0), w->elesz);
+  else
+    w->op(dest, AGG(w, 0), w->backagg);
+  return 0;
+}
+
+void winagg_clear(struct winagg *w)
+{
+  if (!w)
+    return;
+  deq_clear(&w->deq);
+  w->nfront = 0;
+}
+
+static void flip(struct winagg *w)
+{
+  size_t n = deq_size(&w->deq);
+  memcpy(AGG(w, n - 1), VAL(w, n - 1), w->elesz);
+  for (size_t i = n - 1; i-- > 0;)
+    w->op(AGG(w, i), VAL(w, i), AGG(w, i + 1));
+  w->nfront = n;
+}
@@ -1,6 +1,10 @@
 #include "unit/basic.h"
 #include "unit/edge.h"
+#include "unit/external.h"
 #include "unit/large.h"
+#include "unit/merge.h"
+#include "unit/parallel.h"
+#include "unit/select.h"
 
 /* Options: sortins, sortqs, sortheap, sort */
 sortfunc sort_under_test = sort;
@@ -10,4 +14,8 @@ UTEST_SUITE(sort)
   UTEST_RUNCASE(basic);
   UTEST_RUNCASE(edge);
   UTEST_RUNCASE(large);
+  UTEST_RUNCASE(select);
+  UTEST_RUNCASE(parallel);
+  UTEST_RUNCASE(external);
+  UTEST_RUNCASE(merge);
 }
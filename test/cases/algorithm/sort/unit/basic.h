@@ -29,6 +29,30 @@ static int sort_cmp_elem512(void *a, void *b)
   return (x > y) - (x < y);
 }
 
+typedef struct {
+  int64_t key;
+  int64_t aux;
+} sort_elem16;
+
+typedef struct {
+  int64_t key;
+  int64_t aux[3];
+} sort_elem32;
+
+static int sort_cmp_elem16(void *a, void *b)
+{
+  int64_t x = ((const sort_elem16 *)a)->key;
+  int64_t y = ((const sort_elem16 *)b)->key;
+  return (x > y) - (x < y);
+}
+
+static int sort_cmp_elem32(void *a, void *b)
+{
+  int64_t x = ((const sort_elem32 *)a)->key;
+  int64_t y = ((const sort_elem32 *)b)->key;
+  return (x > y) - (x < y);
+}
+
 UTEST_CASE(basic)
 {
   {
@@ -253,4 +277,38 @@ UTEST_CASE(basic)
     EXPECT_EQ_INT(sort_under_test(buf, 12, sizeof *buf, sort_cmp_int), 0);
     EXPECT_TRUE(sort_sorted(buf, 12, sizeof *buf, sort_cmp_int));
   }
+
+  {
+    sort_elem16 buf[40];
+    size_t i;
+
+    sort_rng_seed(0x16u);
+    for (i = 0; i < 40; i++) {
+      buf[i].key = (int64_t)(sort_rng_u32() % 100);
+      buf[i].aux = -buf[i].key;
+    }
+    EXPECT_EQ_INT(sort_under_test(buf, 40, sizeof *buf, sort_cmp_elem16), 0);
+    EXPECT_TRUE(sort_sorted(buf, 40, sizeof *buf, sort_cmp_elem16));
+    for (i = 0; i < 40; i++)
+      EXPECT_EQ_INT(buf[i].aux, -buf[i].key);
+  }
+
+  {
+    sort_elem32 buf[40];
+    size_t i;
+
+    sort_rng_seed(0x32u);
+    for (i = 0; i < 40; i++) {
+      buf[i].key = (int64_t)(sort_rng_u32() % 100);
+      buf[i].aux[0] = buf[i].aux[2] = buf[i].key * 3;
+      buf[i].aux[1] = -buf[i].key;
+    }
+    EXPECT_EQ_INT(sort_under_test(buf, 40, sizeof *buf, sort_cmp_elem32), 0);
+    EXPECT_TRUE(sort_sorted(buf, 40, sizeof *buf, sort_cmp_elem32));
+    for (i = 0; i < 40; i++) {
+      EXPECT_EQ_INT(buf[i].aux[0], buf[i].key * 3);
+      EXPECT_EQ_INT(buf[i].aux[1], -buf[i].key);
+      EXPECT_EQ_INT(buf[i].aux[2], buf[i].key * 3);
+    }
+  }
 }
@@ -267,4 +267,38 @@ UTEST_CASE(edge)
     for (i = 0; i < sizeof buf[1].tail; i++)
       EXPECT_EQ_UCHAR(buf[1].tail[i], (unsigned char)((k0 + (int)i) & 0xFF));
   }
+
+  {
+    size_t n = 257;
+    int buf[257];
+    size_t i;
+
+    sort_rng_seed(0x4EA9u);
+    for (i = 0; i < n; i++)
+      buf[i] = (int)(sort_rng_u32() % 64);
+    EXPECT_EQ_INT(sortheap(buf, n, sizeof *buf, sort_cmp_int), 0);
+    EXPECT_TRUE(sort_sorted(buf, n, sizeof *buf, sort_cmp_int));
+  }
+
+  {
+    sort_big300 *buf;
+    size_t n = 33;
+    size_t i, j;
+
+    buf = malloc(n * sizeof *buf);
+    EXPECT_NOTNULL(buf);
+    sort_rng_seed(0x300u);
+    for (i = 0; i < n; i++) {
+      buf[i].k = (int)(sort_rng_u32() % 1000);
+      for (j = 0; j < sizeof buf[i].tail; j++)
+        buf[i].tail[j] = (unsigned char)(buf[i].k + j);
+    }
+    EXPECT_EQ_INT(sortheap(buf, n, sizeof *buf, sort_cmp_big300), 0);
+    EXPECT_TRUE(sort_sorted(buf, n, sizeof *buf, sort_cmp_big300));
+    for (i = 0; i < n; i++) {
+      for (j = 0; j < sizeof buf[i].tail; j++)
+        EXPECT_EQ_UCHAR(buf[i].tail[j], (unsigned char)(buf[i].k + j));
+    }
+    free(buf);
+  }
 }
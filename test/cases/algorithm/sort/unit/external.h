@@ -0,0 +1,132 @@
+#include "common.h"
+#include <stdio.h>
+#include <unistd.h>
+
+static FILE *sort_ext_input(const void *buf, size_t len)
+{
+  FILE *fp = tmpfile();
+  if (!fp)
+    return NULL;
+  if (len && fwrite(buf, 1, len, fp) != len) {
+    fclose(fp);
+    return NULL;
+  }
+  fflush(fp);
+  rewind(fp);
+  return fp;
+}
+
+UTEST_CASE(external)
+{
+  {
+    EXPECT_EQ_INT(sort_ext(-1, 1, sizeof(int), sort_cmp_int, 4096), -1);
+    EXPECT_EQ_INT(sort_ext(0, 1, 0, sort_cmp_int, 4096), -1);
+    EXPECT_EQ_INT(sort_ext(0, 1, sizeof(int), NULL, 4096), -1);
+    EXPECT_EQ_INT(sort_ext(0, 1, sizeof(int), sort_cmp_int, sizeof(int)), -1);
+    EXPECT_EQ_INT(sort_ext(0, 1, sizeof(int), sort_cmp_int, 2 * sizeof(int)),
+                  -1);
+  }
+
+  {
+    size_t budgets[] = {64, 4096, 1 << 20};
+    size_t n = 10007;
+    int *buf = malloc(n * sizeof *buf);
+    int *res = malloc(n * sizeof *res);
+    size_t b, i;
+    int64_t want, sum;
+
+    EXPECT_NOTNULL(buf);
+    EXPECT_NOTNULL(res);
+    for (b = 0; b < sizeof budgets / sizeof budgets[0]; b++) {
+      FILE *in, *out;
+
+      sort_rng_seed(0xE7u + b);
+      want = 0;
+      for (i = 0; i < n; i++) {
+        buf[i] = (int)(sort_rng_u32() % 100000);
+        want += buf[i];
+      }
+      in = sort_ext_input(buf, n * sizeof *buf);
+      out = tmpfile();
+      EXPECT_NOTNULL(in);
+      EXPECT_NOTNULL(out);
+      EXPECT_EQ_INT(sort_ext(fileno(in), fileno(out), sizeof *buf,
+                             sort_cmp_int, budgets[b]),
+                    0);
+      EXPECT_EQ_INT(lseek(fileno(out), 0, SEEK_END),
+                    (int64_t)(n * sizeof *res));
+      rewind(out);
+      EXPECT_EQ_UINT(fread(res, sizeof *res, n, out), n);
+      EXPECT_TRUE(sort_sorted(res, n, sizeof *res, sort_cmp_int));
+      sum = 0;
+      for (i = 0; i < n; i++)
+        sum += res[i];
+      EXPECT_EQ_INT(sum, want);
+      fclose(in);
+      fclose(out);
+    }
+    free(buf);
+    free(res);
+  }
+
+  {
+    /* Three records of memory give runs of three and a fan-in of two, so
+       thousands of runs take a dozen merge passes */
+    size_t n = 20000, i;
+    int *buf = malloc(n * sizeof *buf);
+    int *res = malloc(n * sizeof *res);
+    int64_t want = 0, sum = 0;
+    FILE *in, *out;
+
+    EXPECT_NOTNULL(buf);
+    EXPECT_NOTNULL(res);
+    sort_rng_seed(0x3A55u);
+    for (i = 0; i < n; i++) {
+      buf[i] = (int)(sort_rng_u32() % 1000) - 500;
+      want += buf[i];
+    }
+    in = sort_ext_input(buf, n * sizeof *buf);
+    out = tmpfile();
+    EXPECT_NOTNULL(in);
+    EXPECT_NOTNULL(out);
+    EXPECT_EQ_INT(sort_ext(fileno(in), fileno(out), sizeof *buf, sort_cmp_int,
+                           3 * sizeof *buf),
+                  0);
+    rewind(out);
+    EXPECT_EQ_UINT(fread(res, sizeof *res, n, out), n);
+    EXPECT_TRUE(sort_sorted(res, n, sizeof *res, sort_cmp_int));
+    for (i = 0; i < n; i++)
+      sum += res[i];
+    EXPECT_EQ_INT(sum, want);
+    fclose(in);
+    fclose(out);
+    free(buf);
+    free(res);
+  }
+
+  {
+    FILE *in = sort_ext_input(NULL, 0);
+    FILE *out = tmpfile();
+
+    EXPECT_NOTNULL(in);
+    EXPECT_NOTNULL(out);
+    EXPECT_EQ_INT(
+        sort_ext(fileno(in), fileno(out), sizeof(int), sort_cmp_int, 4096), 0);
+    EXPECT_EQ_INT(lseek(fileno(out), 0, SEEK_END), 0);
+    fclose(in);
+    fclose(out);
+  }
+
+  {
+    char partial[] = {1, 2, 3, 4, 5, 6};
+    FILE *in = sort_ext_input(partial, sizeof partial);
+    FILE *out = tmpfile();
+
+    EXPECT_NOTNULL(in);
+    EXPECT_NOTNULL(out);
+    EXPECT_EQ_INT(
+        sort_ext(fileno(in), fileno(out), sizeof(int), sort_cmp_int, 4096), -1);
+    fclose(in);
+    fclose(out);
+  }
+}
@@ -0,0 +1,74 @@
+#include "common.h"
+#include <vector.h>
+
+typedef struct {
+  int key;
+  int run;
+} sort_mrec;
+
+static int sort_cmp_mrec(void *a, void *b)
+{
+  int x = ((const sort_mrec *)a)->key;
+  int y = ((const sort_mrec *)b)->key;
+  return (x > y) - (x < y);
+}
+
+UTEST_CASE(merge)
+{
+  {
+    struct vector runs[2], out, bad;
+
+    EXPECT_EQ_INT(vec_init(&runs[0], sizeof(int), NULL), 0);
+    EXPECT_EQ_INT(vec_init(&runs[1], sizeof(int), NULL), 0);
+    EXPECT_EQ_INT(vec_init(&out, sizeof(int), NULL), 0);
+    EXPECT_EQ_INT(vec_init(&bad, sizeof(char), NULL), 0);
+    EXPECT_EQ_INT(merge_k(NULL, 2, &out, sort_cmp_int), -1);
+    EXPECT_EQ_INT(merge_k(runs, 2, NULL, sort_cmp_int), -1);
+    EXPECT_EQ_INT(merge_k(runs, 2, &out, NULL), -1);
+    EXPECT_EQ_INT(merge_k(runs, 2, &bad, sort_cmp_int), -1);
+    EXPECT_EQ_INT(merge_k(runs, 2, &out, sort_cmp_int), 0);
+    EXPECT_EQ_INT(merge_k(runs, 0, &out, sort_cmp_int), 0);
+    EXPECT_TRUE(vec_empty(&out));
+    vec_fini(&runs[0]);
+    vec_fini(&runs[1]);
+    vec_fini(&out);
+    vec_fini(&bad);
+  }
+
+  {
+    size_t ks[] = {1, 2, 3, 5, 8, 13};
+    size_t t, i, j;
+
+    for (t = 0; t < sizeof ks / sizeof ks[0]; t++) {
+      size_t k = ks[t];
+      struct vector runs[13], out;
+      size_t total = 0;
+      sort_mrec head = {-1, -1};
+
+      sort_rng_seed(0x3E96u + t);
+      for (i = 0; i < k; i++) {
+        size_t len = sort_rng_u32() % 200;
+        EXPECT_EQ_INT(vec_init(&runs[i], sizeof(sort_mrec), NULL), 0);
+        for (j = 0; j < len; j++) {
+          sort_mrec r = {(int)(sort_rng_u32() % 50), (int)i};
+          EXPECT_EQ_INT(vec_pushback(&runs[i], &r), 0);
+        }
+        sort(vec_raw(&runs[i]), len, sizeof(sort_mrec), sort_cmp_mrec);
+        total += len;
+      }
+      EXPECT_EQ_INT(vec_init(&out, sizeof(sort_mrec), NULL), 0);
+      EXPECT_EQ_INT(vec_pushback(&out, &head), 0);
+      EXPECT_EQ_INT(merge_k(runs, k, &out, sort_cmp_mrec), 0);
+      EXPECT_EQ_UINT(vec_size(&out), total + 1);
+      for (i = 1; i < vec_size(&out); i++) {
+        sort_mrec *p = vec_at(&out, i - 1), *q = vec_at(&out, i);
+        EXPECT_LE_INT(p->key, q->key);
+        if (i > 1 && p->key == q->key)
+          EXPECT_LE_INT(p->run, q->run);
+      }
+      for (i = 0; i < k; i++)
+        vec_fini(&runs[i]);
+      vec_fini(&out);
+    }
+  }
+}
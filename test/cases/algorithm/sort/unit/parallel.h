@@ -0,0 +1,53 @@
+#include "common.h"
+
+UTEST_CASE(parallel)
+{
+  {
+    int buf[] = {3, 1, 2};
+    EXPECT_EQ_INT(sort_par(NULL, 3, sizeof *buf, sort_cmp_int, 4), -1);
+    EXPECT_EQ_INT(sort_par(buf, 3, 0, sort_cmp_int, 4), -1);
+    EXPECT_EQ_INT(sort_par(buf, 3, sizeof *buf, NULL, 4), -1);
+    EXPECT_EQ_INT(sort_par(buf, 3, sizeof *buf, sort_cmp_int, 4), 0);
+    EXPECT_TRUE(sort_sorted(buf, 3, sizeof *buf, sort_cmp_int));
+  }
+
+  {
+    size_t n = 100003;
+    size_t nthreads[] = {0, 1, 2, 3, 4, 7, 8};
+    int *buf = malloc(n * sizeof *buf);
+    int64_t sum, want;
+    size_t i, t;
+
+    EXPECT_NOTNULL(buf);
+    for (t = 0; t < sizeof nthreads / sizeof nthreads[0]; t++) {
+      sort_rng_seed(0x9A4u + t);
+      want = 0;
+      for (i = 0; i < n; i++) {
+        buf[i] = (int)(sort_rng_u32() % 5000);
+        want += buf[i];
+      }
+      EXPECT_EQ_INT(sort_par(buf, n, sizeof *buf, sort_cmp_int, nthreads[t]),
+                    0);
+      EXPECT_TRUE(sort_sorted(buf, n, sizeof *buf, sort_cmp_int));
+      sum = 0;
+      for (i = 0; i < n; i++)
+        sum += buf[i];
+      EXPECT_EQ_INT(sum, want);
+    }
+    free(buf);
+  }
+
+  {
+    size_t n = 60000;
+    int64_t *buf = malloc(n * sizeof *buf);
+    size_t i;
+
+    EXPECT_NOTNULL(buf);
+    for (i = 0; i < n; i++)
+      buf[i] = (int64_t)(n - i);
+    EXPECT_EQ_INT(sort_par(buf, n, sizeof *buf, sort_cmp_i64, 5), 0);
+    for (i = 0; i < n; i++)
+      EXPECT_EQ_INT(buf[i], (int64_t)(i + 1));
+    free(buf);
+  }
+}
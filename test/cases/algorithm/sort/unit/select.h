@@ -0,0 +1,76 @@
+#include "common.h"
+
+UTEST_CASE(select)
+{
+  {
+    int buf[] = {5, 1, 4};
+    EXPECT_EQ_INT(select_nth(NULL, 3, 0, sizeof *buf, sort_cmp_int), -1);
+    EXPECT_EQ_INT(select_nth(buf, 3, 3, sizeof *buf, sort_cmp_int), -1);
+    EXPECT_EQ_INT(select_nth(buf, 3, 0, 0, sort_cmp_int), -1);
+    EXPECT_EQ_INT(select_nth(buf, 3, 0, sizeof *buf, NULL), -1);
+    EXPECT_EQ_INT(sort_partial(NULL, 3, 1, sizeof *buf, sort_cmp_int), -1);
+  }
+
+  {
+    int buf[] = {5, 1, 4};
+    EXPECT_EQ_INT(select_nth(buf, 3, 1, sizeof *buf, sort_cmp_int), 0);
+    EXPECT_EQ_INT(buf[1], 4);
+  }
+
+  {
+    size_t n = 1000;
+    int buf[1000], ref[1000];
+    size_t ks[] = {0, 1, 17, 500, 998, 999};
+    size_t i, j;
+
+    for (j = 0; j < sizeof ks / sizeof ks[0]; j++) {
+      size_t k = ks[j];
+      sort_rng_seed(0x5E1Eu + j);
+      for (i = 0; i < n; i++)
+        ref[i] = buf[i] = (int)(sort_rng_u32() % 300);
+      EXPECT_EQ_INT(sort(ref, n, sizeof *ref, sort_cmp_int), 0);
+      EXPECT_EQ_INT(select_nth(buf, n, k, sizeof *buf, sort_cmp_int), 0);
+      EXPECT_EQ_INT(buf[k], ref[k]);
+      for (i = 0; i < k; i++)
+        EXPECT_LE_INT(buf[i], buf[k]);
+      for (i = k + 1; i < n; i++)
+        EXPECT_GE_INT(buf[i], buf[k]);
+    }
+  }
+
+  {
+    size_t n = 600;
+    int buf[600];
+    size_t i;
+
+    for (i = 0; i < n; i++)
+      buf[i] = (int)(n - i);
+    EXPECT_EQ_INT(select_nth(buf, n, 300, sizeof *buf, sort_cmp_int), 0);
+    EXPECT_EQ_INT(buf[300], 301);
+  }
+
+  {
+    size_t n = 1000, k = 100;
+    int buf[1000], ref[1000];
+    size_t i;
+
+    sort_rng_seed(0x7A27u);
+    for (i = 0; i < n; i++)
+      ref[i] = buf[i] = (int)(sort_rng_u32() % 100000);
+    EXPECT_EQ_INT(sort(ref, n, sizeof *ref, sort_cmp_int), 0);
+    EXPECT_EQ_INT(sort_partial(buf, n, k, sizeof *buf, sort_cmp_int), 0);
+    for (i = 0; i < k; i++)
+      EXPECT_EQ_INT(buf[i], ref[i]);
+    for (i = k; i < n; i++)
+      EXPECT_GE_INT(buf[i], buf[k - 1]);
+  }
+
+  {
+    int buf[] = {3, 2, 1};
+    EXPECT_EQ_INT(sort_partial(buf, 3, 0, sizeof *buf, sort_cmp_int), 0);
+    EXPECT_EQ_INT(sort_partial(buf, 3, 5, sizeof *buf, sort_cmp_int), 0);
+    EXPECT_EQ_INT(buf[0], 1);
+    EXPECT_EQ_INT(buf[1], 2);
+    EXPECT_EQ_INT(buf[2], 3);
+  }
+}
@@ -1,3 +1,4 @@
+#include <stdint.h>
 #include <stdlib.h>
 #include <utest.h>
 #include <util.h>
@@ -118,4 +119,41 @@ UTEST_CASE(swap)
     free(p);
     free(q);
   }
+
+  {
+    unsigned char u[100];
+    unsigned char v[100];
+    size_t sizes[] = {16, 32, 64, 72, 100};
+    size_t k, idx;
+
+    for (k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+      for (idx = 0; idx < sizeof(u); idx++) {
+        u[idx] = (unsigned char)idx;
+        v[idx] = (unsigned char)(200 - idx);
+      }
+      swap(u, v, sizes[k]);
+      for (idx = 0; idx < sizes[k]; idx++) {
+        EXPECT_EQ_UCHAR(u[idx], (unsigned char)(200 - idx));
+        EXPECT_EQ_UCHAR(v[idx], (unsigned char)idx);
+      }
+      for (; idx < sizeof(u); idx++) {
+        EXPECT_EQ_UCHAR(u[idx], (unsigned char)idx);
+        EXPECT_EQ_UCHAR(v[idx], (unsigned char)(200 - idx));
+      }
+    }
+  }
+
+  {
+    uint64_t a[4] = {1, 2, 3, 4};
+    uint64_t b[4] = {5, 6, 7, 8};
+
+    swap8(&a[0], &b[0]);
+    EXPECT_EQ_UINT(a[0], 5);
+    EXPECT_EQ_UINT(b[0], 1);
+    swap32(a, b);
+    EXPECT_EQ_UINT(a[0], 1);
+    EXPECT_EQ_UINT(a[3], 8);
+    EXPECT_EQ_UINT(b[0], 5);
+    EXPECT_EQ_UINT(b[3], 4);
+  }
 }
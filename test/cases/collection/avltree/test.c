@@ -1,10 +1,18 @@
+#include "unit/balance.h"
 #include "unit/basic.h"
+#include "unit/bulk.h"
 #include "unit/edge.h"
 #include "unit/integration.h"
+#include "unit/iter.h"
+#include "unit/order.h"
 
 UTEST_SUITE(avltree)
 {
   UTEST_RUNCASE(basic);
   UTEST_RUNCASE(edge);
   UTEST_RUNCASE(integration);
+  UTEST_RUNCASE(balance);
+  UTEST_RUNCASE(iter);
+  UTEST_RUNCASE(order);
+  UTEST_RUNCASE(bulk);
 }
\ No newline at end of file
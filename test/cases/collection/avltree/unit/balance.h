@@ -0,0 +1,98 @@
+#include <avltree.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <utest.h>
+
+static int bal_cmp(void *a, void *b)
+{
+  intptr_t x = *(intptr_t *)a, y = *(intptr_t *)b;
+  return (x > y) - (x < y);
+}
+
+/* Height of a subtree, or -2 if the heights, counts, balance or key order are
+   off */
+static int bal_check(struct avltree_node *node, intptr_t *lo, intptr_t *hi)
+{
+  if (!node)
+    return -1;
+  intptr_t k = *(intptr_t *)node->key;
+  if ((lo && k <= *lo) || (hi && k >= *hi))
+    return -2;
+  int l = bal_check(node->left, lo, (intptr_t *)node->key);
+  int r = bal_check(node->right, (intptr_t *)node->key, hi);
+  if (l == -2 || r == -2 || l - r > 1 || r - l > 1)
+    return -2;
+  int h = 1 + (l > r ? l : r);
+  size_t c = 1 + (node->left ? node->left->count : 0) +
+             (node->right ? node->right->count : 0);
+  return h == node->height && c == node->count ? h : -2;
+}
+
+UTEST_CASE(balance)
+{
+  {
+    /* Sorted inserts would make an unbalanced tree as deep as it is large,
+       clear must still not recurse */
+    struct avltree t;
+    struct avltree_fns fns = {bal_cmp, NULL, NULL};
+    size_t n = 1 << 16, i;
+    intptr_t *keys = malloc(n * sizeof *keys);
+
+    EXPECT_NOTNULL(keys);
+    EXPECT_EQ_INT(avltree_init(&t, &fns), 0);
+    for (i = 0; i < n; i++) {
+      keys[i] = (intptr_t)i;
+      EXPECT_EQ_INT(avltree_insert(&t, &keys[i], &keys[i]), 0);
+    }
+    EXPECT_EQ_INT(avltree_insert(&t, &keys[7], NULL), -1);
+    EXPECT_EQ_UINT(avltree_size(&t), n);
+    EXPECT_LE_INT(avltree_root(&t)->height, 17);
+    EXPECT_GE_INT(bal_check(avltree_root(&t), NULL, NULL), 0);
+    avltree_clear(&t);
+    EXPECT_NULL(avltree_root(&t));
+    EXPECT_EQ_UINT(avltree_size(&t), 0);
+    avltree_fini(&t);
+    free(keys);
+  }
+
+  {
+    /* Random inserts and removes, including nodes with two children */
+    struct avltree t;
+    struct avltree_fns fns = {bal_cmp, NULL, NULL};
+    intptr_t keys[2048];
+    char in[2048] = {0};
+    size_t live = 0;
+    unsigned seed = 11u;
+    int i;
+    void *val;
+
+    for (i = 0; i < 2048; i++)
+      keys[i] = i * 3;
+    EXPECT_EQ_INT(avltree_init(&t, &fns), 0);
+    for (i = 0; i < 40000; i++) {
+      seed = seed * 1103515245u + 12345u;
+      int k = (int)((seed >> 16) % 2048);
+      if (in[k]) {
+        val = NULL;
+        EXPECT_EQ_INT(avltree_remove(&t, &keys[k], &val), 0);
+        EXPECT_EQ_PTR(val, &keys[k]);
+        EXPECT_EQ_INT(avltree_remove(&t, &keys[k], NULL), -1);
+        in[k] = 0;
+        live--;
+      } else {
+        EXPECT_EQ_INT(avltree_insert(&t, &keys[k], &keys[k]), 0);
+        in[k] = 1;
+        live++;
+      }
+      if (i % 1000 == 0) {
+        int j;
+        EXPECT_GE_INT(bal_check(avltree_root(&t), NULL, NULL), 0);
+        for (j = 0; j < 2048; j++)
+          EXPECT_EQ_PTR(avltree_find(&t, &keys[j]), in[j] ? &keys[j] : NULL);
+      }
+      EXPECT_EQ_UINT(avltree_size(&t), live);
+    }
+    EXPECT_GE_INT(bal_check(avltree_root(&t), NULL, NULL), 0);
+    avltree_fini(&t);
+  }
+}
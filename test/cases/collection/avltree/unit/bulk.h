@@ -0,0 +1,127 @@
+#include <avltree.h>
+#include <stdint.h>
+#include <utest.h>
+
+static int bulk_cmp(void *a, void *b)
+{
+  intptr_t x = *(intptr_t *)a, y = *(intptr_t *)b;
+  return (x > y) - (x < y);
+}
+
+/* Height of a subtree, or -2 if the heights, counts, balance or key order are
+   off */
+static int bulk_check(struct avltree_node *node, intptr_t *lo, intptr_t *hi)
+{
+  if (!node)
+    return -1;
+  intptr_t k = *(intptr_t *)node->key;
+  if ((lo && k <= *lo) || (hi && k >= *hi))
+    return -2;
+  int l = bulk_check(node->left, lo, (intptr_t *)node->key);
+  int r = bulk_check(node->right, (intptr_t *)node->key, hi);
+  if (l == -2 || r == -2 || l - r > 1 || r - l > 1)
+    return -2;
+  int h = 1 + (l > r ? l : r);
+  size_t c = 1 + (node->left ? node->left->count : 0) +
+             (node->right ? node->right->count : 0);
+  return h == node->height && c == node->count ? h : -2;
+}
+
+UTEST_CASE(bulk)
+{
+  static intptr_t keys[4096];
+  static void *kp[4096], *vp[4096];
+  struct avltree_fns fns = {bulk_cmp, NULL, NULL};
+  struct avltree a, b;
+  intptr_t probe;
+  size_t i, n, at;
+
+  for (i = 0; i < 4096; i++) {
+    keys[i] = (intptr_t)i;
+    kp[i] = &keys[i];
+    vp[i] = &keys[4095 - i];
+  }
+
+  {
+    /* Every size up to 300 builds a valid tree of minimal height */
+    EXPECT_EQ_INT(avltree_init(&a, &fns), 0);
+    for (n = 0; n <= 300; n++) {
+      EXPECT_EQ_INT(avltree_build_sorted(&a, kp, vp, n), 0);
+      EXPECT_EQ_UINT(avltree_size(&a), n);
+      int want = -1;
+      for (i = n; i; i >>= 1)
+        want++;
+      EXPECT_EQ_INT(bulk_check(avltree_root(&a), NULL, NULL), want);
+      for (i = 0; i < n; i += 37)
+        EXPECT_EQ_PTR(avltree_find(&a, &keys[i]), &keys[4095 - i]);
+      avltree_clear(&a);
+    }
+
+    /* Unsorted, duplicate or NULL keys and a non-empty tree are refused */
+    void *bad[3] = {&keys[1], &keys[0], &keys[2]};
+    void *dup[3] = {&keys[0], &keys[1], &keys[1]};
+    void *nul[2] = {&keys[0], NULL};
+    EXPECT_EQ_INT(avltree_build_sorted(&a, bad, NULL, 3), -1);
+    EXPECT_EQ_INT(avltree_build_sorted(&a, dup, NULL, 3), -1);
+    EXPECT_EQ_INT(avltree_build_sorted(&a, nul, NULL, 2), -1);
+    EXPECT_NULL(avltree_root(&a));
+    EXPECT_EQ_INT(avltree_build_sorted(&a, kp, NULL, 10), 0);
+    EXPECT_NULL(avltree_find(&a, &keys[3]));
+    EXPECT_EQ_INT(avltree_build_sorted(&a, kp, NULL, 10), -1);
+    avltree_fini(&a);
+  }
+
+  {
+    /* Split at many points and join back, in both argument orders */
+    EXPECT_EQ_INT(avltree_init(&a, &fns), 0);
+    EXPECT_EQ_INT(avltree_init(&b, &fns), 0);
+    EXPECT_EQ_INT(avltree_build_sorted(&a, kp, vp, 4096), 0);
+    for (at = 0; at <= 4100; at += 211) {
+      probe = (intptr_t)at;
+      EXPECT_EQ_INT(avltree_split(&a, &probe, &b), 0);
+      n = at < 4096 ? at : 4096;
+      EXPECT_EQ_UINT(avltree_size(&a), n);
+      EXPECT_EQ_UINT(avltree_size(&b), 4096 - n);
+      EXPECT_GE_INT(bulk_check(avltree_root(&a), NULL, NULL), -1);
+      EXPECT_GE_INT(bulk_check(avltree_root(&b), NULL, NULL), -1);
+      if (n)
+        EXPECT_EQ_PTR(avltree_last(&a)->key, &keys[n - 1]);
+      if (n < 4096)
+        EXPECT_EQ_PTR(avltree_first(&b)->key, &keys[n]);
+      EXPECT_EQ_INT(avltree_split(&a, &probe, &b), -1);
+      if (at % 2) {
+        EXPECT_EQ_INT(avltree_join(&a, &b), 0);
+      } else {
+        EXPECT_EQ_INT(avltree_join(&b, &a), 0);
+        EXPECT_EQ_INT(avltree_join(&a, &b), 0);
+      }
+      EXPECT_EQ_UINT(avltree_size(&a), 4096);
+      EXPECT_EQ_UINT(avltree_size(&b), 0);
+      EXPECT_NULL(avltree_root(&b));
+      EXPECT_GE_INT(bulk_check(avltree_root(&a), NULL, NULL), 0);
+      EXPECT_EQ_PTR(avltree_select(&a, 1234)->key, &keys[1234]);
+    }
+
+    /* Joining trees of very different heights, then overlapping ranges */
+    probe = 4090;
+    EXPECT_EQ_INT(avltree_split(&a, &probe, &b), 0);
+    EXPECT_EQ_INT(avltree_join(&b, &a), 0);
+    EXPECT_GE_INT(bulk_check(avltree_root(&b), NULL, NULL), 0);
+    probe = 3;
+    EXPECT_EQ_INT(avltree_split(&b, &probe, &a), 0);
+    EXPECT_EQ_INT(avltree_join(&a, &b), 0);
+    EXPECT_GE_INT(bulk_check(avltree_root(&a), NULL, NULL), 0);
+    EXPECT_EQ_UINT(avltree_size(&a), 4096);
+
+    probe = 2000;
+    EXPECT_EQ_INT(avltree_split(&a, &probe, &b), 0);
+    EXPECT_EQ_INT(avltree_remove(&b, &keys[3000], NULL), 0);
+    EXPECT_EQ_INT(avltree_insert(&a, &keys[3000], NULL), 0);
+    EXPECT_EQ_INT(avltree_join(&a, &b), -1);
+    EXPECT_EQ_UINT(avltree_size(&a), 2001);
+    EXPECT_EQ_UINT(avltree_size(&b), 2095);
+    EXPECT_EQ_INT(avltree_join(&a, &a), -1);
+    avltree_fini(&a);
+    avltree_fini(&b);
+  }
+}
@@ -0,0 +1,110 @@
+#include <avltree.h>
+#include <stdint.h>
+#include <utest.h>
+
+static int iter_cmp(void *a, void *b)
+{
+  intptr_t x = *(intptr_t *)a, y = *(intptr_t *)b;
+  return (x > y) - (x < y);
+}
+
+static int iter_collect(struct avltree_node *node, void *arg)
+{
+  intptr_t *out = arg;
+  out[++out[0]] = *(intptr_t *)node->key;
+  return out[0] == 5;
+}
+
+UTEST_CASE(iter)
+{
+  struct avltree t;
+  struct avltree_fns fns = {iter_cmp, NULL, NULL};
+  struct avltree_iter it;
+  intptr_t keys[500], probe, lo, hi, out[16];
+  int i;
+
+  EXPECT_EQ_INT(avltree_init(&t, &fns), 0);
+  probe = 0;
+  EXPECT_NULL(avltree_first(&t));
+  EXPECT_NULL(avltree_last(&t));
+  EXPECT_NULL(avltree_lower_bound(&t, &probe));
+  EXPECT_EQ_INT(avltree_iter_init(&it, &t), 0);
+  EXPECT_NULL(avltree_iter_get(&it));
+  EXPECT_EQ_INT(avltree_iter_init(NULL, &t), -1);
+
+  /* Even keys 0..998 inserted in a scrambled order */
+  for (i = 0; i < 500; i++) {
+    keys[i] = ((i * 7) % 500) * 2;
+    EXPECT_EQ_INT(avltree_insert(&t, &keys[i], NULL), 0);
+  }
+  EXPECT_EQ_INT(*(intptr_t *)avltree_first(&t)->key, 0);
+  EXPECT_EQ_INT(*(intptr_t *)avltree_last(&t)->key, 998);
+
+  probe = 41;
+  EXPECT_EQ_INT(*(intptr_t *)avltree_lower_bound(&t, &probe)->key, 42);
+  EXPECT_EQ_INT(*(intptr_t *)avltree_upper_bound(&t, &probe)->key, 42);
+  probe = 42;
+  EXPECT_EQ_INT(*(intptr_t *)avltree_lower_bound(&t, &probe)->key, 42);
+  EXPECT_EQ_INT(*(intptr_t *)avltree_upper_bound(&t, &probe)->key, 44);
+  probe = -5;
+  EXPECT_EQ_INT(*(intptr_t *)avltree_lower_bound(&t, &probe)->key, 0);
+  probe = 998;
+  EXPECT_NULL(avltree_upper_bound(&t, &probe));
+  probe = 999;
+  EXPECT_NULL(avltree_lower_bound(&t, &probe));
+
+  /* Forward then backward over the whole tree */
+  EXPECT_EQ_INT(avltree_iter_init(&it, &t), 0);
+  for (i = 0; i < 500; i++) {
+    EXPECT_NOTNULL(avltree_iter_get(&it));
+    EXPECT_EQ_INT(*(intptr_t *)avltree_iter_get(&it)->key, i * 2);
+    avltree_iter_inc(&it);
+  }
+  EXPECT_NULL(avltree_iter_get(&it));
+  avltree_iter_inc(&it);
+  EXPECT_NULL(avltree_iter_get(&it));
+
+  EXPECT_EQ_INT(avltree_iter_rinit(&it, &t), 0);
+  for (i = 499; i >= 0; i--) {
+    EXPECT_EQ_INT(*(intptr_t *)avltree_iter_get(&it)->key, i * 2);
+    avltree_iter_dec(&it);
+  }
+  EXPECT_NULL(avltree_iter_get(&it));
+
+  /* Seek then walk both ways from the middle */
+  probe = 301;
+  EXPECT_EQ_INT(avltree_iter_seek(&it, &t, &probe), 0);
+  EXPECT_EQ_INT(*(intptr_t *)avltree_iter_get(&it)->key, 302);
+  avltree_iter_dec(&it);
+  EXPECT_EQ_INT(*(intptr_t *)avltree_iter_get(&it)->key, 300);
+  avltree_iter_dec(&it);
+  EXPECT_EQ_INT(*(intptr_t *)avltree_iter_get(&it)->key, 298);
+  avltree_iter_inc(&it);
+  avltree_iter_inc(&it);
+  avltree_iter_inc(&it);
+  EXPECT_EQ_INT(*(intptr_t *)avltree_iter_get(&it)->key, 304);
+  probe = 2000;
+  EXPECT_EQ_INT(avltree_iter_seek(&it, &t, &probe), 0);
+  EXPECT_NULL(avltree_iter_get(&it));
+
+  /* Half-open ranges, open bounds and early stop */
+  lo = 10;
+  hi = 17;
+  out[0] = 0;
+  EXPECT_EQ_UINT(avltree_range(&t, &lo, &hi, iter_collect, out), 4);
+  EXPECT_EQ_INT(out[0], 4);
+  EXPECT_EQ_INT(out[1], 10);
+  EXPECT_EQ_INT(out[4], 16);
+  hi = 10;
+  EXPECT_EQ_UINT(avltree_range(&t, &lo, &hi, iter_collect, out), 0);
+  out[0] = 0;
+  EXPECT_EQ_UINT(avltree_range(&t, NULL, NULL, iter_collect, out), 5);
+  EXPECT_EQ_INT(out[5], 8);
+  lo = 995;
+  out[0] = 0;
+  EXPECT_EQ_UINT(avltree_range(&t, &lo, NULL, iter_collect, out), 2);
+  EXPECT_EQ_INT(out[2], 998);
+  EXPECT_EQ_UINT(avltree_range(&t, NULL, NULL, NULL, NULL), 0);
+
+  avltree_fini(&t);
+}
@@ -0,0 +1,78 @@
+#include <avltree.h>
+#include <stdint.h>
+#include <utest.h>
+
+static int order_cmp(void *a, void *b)
+{
+  intptr_t x = *(intptr_t *)a, y = *(intptr_t *)b;
+  return (x > y) - (x < y);
+}
+
+UTEST_CASE(order)
+{
+  struct avltree t;
+  struct avltree_fns fns = {order_cmp, NULL, NULL};
+  intptr_t keys[1024], lo, hi, probe;
+  char in[1024] = {0};
+  unsigned seed = 7u;
+  size_t live = 0, below, i;
+  int round;
+
+  EXPECT_EQ_INT(avltree_init(&t, &fns), 0);
+  EXPECT_NULL(avltree_select(&t, 0));
+  probe = 5;
+  EXPECT_EQ_UINT(avltree_rank(&t, &probe), 0);
+  EXPECT_EQ_UINT(avltree_count_range(&t, NULL, NULL), 0);
+
+  for (i = 0; i < 1024; i++)
+    keys[i] = (intptr_t)i * 2;
+
+  /* Random churn, checking every order statistic against the bitmap */
+  for (round = 0; round < 20000; round++) {
+    seed = seed * 1103515245u + 12345u;
+    size_t k = (seed >> 16) % 1024;
+    if (in[k]) {
+      EXPECT_EQ_INT(avltree_remove(&t, &keys[k], NULL), 0);
+      in[k] = 0;
+      live--;
+    } else {
+      EXPECT_EQ_INT(avltree_insert(&t, &keys[k], NULL), 0);
+      in[k] = 1;
+      live++;
+    }
+    if (round % 997)
+      continue;
+
+    EXPECT_EQ_UINT(avltree_root(&t) ? avltree_root(&t)->count : 0, live);
+    below = 0;
+    for (i = 0; i < 1024; i++) {
+      probe = keys[i] - 1;
+      EXPECT_EQ_UINT(avltree_rank(&t, &probe), below);
+      EXPECT_EQ_UINT(avltree_rank(&t, &keys[i]), below);
+      if (in[i]) {
+        EXPECT_EQ_PTR(avltree_select(&t, below)->key, &keys[i]);
+        below++;
+      }
+    }
+    EXPECT_EQ_UINT(below, live);
+    EXPECT_NULL(avltree_select(&t, live));
+  }
+
+  /* Half-open counts agree with the range walk */
+  lo = 100;
+  hi = 301;
+  below = 0;
+  for (i = 50; i <= 150; i++)
+    below += (size_t)in[i];
+  EXPECT_EQ_UINT(avltree_count_range(&t, &lo, &hi), below);
+  EXPECT_EQ_UINT(avltree_count_range(&t, &hi, &lo), 0);
+  EXPECT_EQ_UINT(avltree_count_range(&t, &lo, &lo), 0);
+  EXPECT_EQ_UINT(avltree_count_range(&t, NULL, NULL), live);
+  EXPECT_EQ_UINT(avltree_count_range(&t, NULL, &lo) +
+                     avltree_count_range(&t, &lo, NULL),
+                 live);
+
+  avltree_clear(&t);
+  EXPECT_NULL(avltree_select(&t, 0));
+  avltree_fini(&t);
+}
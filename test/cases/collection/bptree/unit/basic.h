@@ -0,0 +1,131 @@
+#include <bptree.h>
+#include <stdint.h>
+#include <utest.h>
+
+static int cmp_int(void *a, void *b)
+{
+  int x = *(int *)a, y = *(int *)b;
+  return (x > y) - (x < y);
+}
+
+static int dtor_val_n;
+
+static void dtor_val(void *p)
+{
+  (void)p;
+  dtor_val_n++;
+}
+
+UTEST_CASE(basic)
+{
+  {
+    /* Pointer keys with a comparator */
+    struct bptree t;
+    struct bptree_fns fns = {cmp_int, NULL, dtor_val};
+    int keys[200], vals[200], probe;
+    void *out;
+
+    EXPECT_EQ_INT(bptree_init(NULL, &fns), -1);
+    EXPECT_EQ_INT(bptree_init(&t, NULL), -1);
+    EXPECT_EQ_INT(bptree_init(&t, &fns), 0);
+    EXPECT_TRUE(bptree_empty(&t));
+    EXPECT_EQ_INT(bptree_insert(&t, NULL, NULL), -1);
+    probe = 3;
+    EXPECT_NULL(bptree_find(&t, &probe));
+    EXPECT_EQ_INT(bptree_remove(&t, &probe, NULL), -1);
+
+    for (int i = 0; i < 200; i++) {
+      keys[i] = (i * 37) % 200;
+      vals[i] = keys[i] * 10;
+      EXPECT_EQ_INT(bptree_insert(&t, &keys[i], &vals[i]), 0);
+    }
+    EXPECT_EQ_UINT(bptree_size(&t), 200);
+    EXPECT_EQ_INT(bptree_insert(&t, &keys[5], NULL), -1);
+    for (probe = 0; probe < 200; probe++)
+      EXPECT_EQ_INT(*(int *)bptree_find(&t, &probe), probe * 10);
+    probe = 200;
+    EXPECT_NULL(bptree_find(&t, &probe));
+    EXPECT_FALSE(bptree_contains(&t, &probe));
+
+    probe = 17;
+    EXPECT_EQ_INT(bptree_update(&t, &probe, &vals[0], &out), 0);
+    EXPECT_EQ_INT(*(int *)out, 170);
+    EXPECT_EQ_PTR(bptree_find(&t, &probe), &vals[0]);
+    dtor_val_n = 0;
+    EXPECT_EQ_INT(bptree_update(&t, &probe, NULL, NULL), 0);
+    EXPECT_EQ_INT(dtor_val_n, 1);
+    EXPECT_TRUE(bptree_contains(&t, &probe));
+    probe = 999;
+    EXPECT_EQ_INT(bptree_update(&t, &probe, NULL, NULL), -1);
+
+    probe = 40;
+    EXPECT_EQ_INT(bptree_remove(&t, &probe, &out), 0);
+    EXPECT_EQ_INT(*(int *)out, 400);
+    EXPECT_EQ_INT(bptree_remove(&t, &probe, NULL), -1);
+    EXPECT_EQ_UINT(bptree_size(&t), 199);
+
+    dtor_val_n = 0;
+    bptree_clear(&t);
+    EXPECT_EQ_INT(dtor_val_n, 199);
+    EXPECT_TRUE(bptree_empty(&t));
+    EXPECT_NULL(t.root);
+    bptree_fini(&t);
+  }
+
+  {
+    /* Integer keys stored in the pointer, 0 and negatives included */
+    struct bptree t;
+    struct bptree_fns fns = {NULL, NULL, NULL};
+    struct bptree_iter it;
+    void *k, *v;
+    intptr_t i, prev;
+
+    EXPECT_EQ_INT(bptree_init(&t, &fns), 0);
+    EXPECT_EQ_INT(bptree_iter_init(&it, &t), 0);
+    EXPECT_EQ_INT(bptree_iter_get(&it, &k, &v), -1);
+    for (i = -500; i < 500; i += 2)
+      EXPECT_EQ_INT(bptree_insert(&t, (void *)(i * 3), (void *)i), 0);
+    EXPECT_EQ_INT(bptree_insert(&t, (void *)0, NULL), -1);
+    EXPECT_TRUE(bptree_contains(&t, (void *)0));
+    EXPECT_EQ_PTR(bptree_find(&t, (void *)-3), NULL);
+    EXPECT_EQ_PTR(bptree_find(&t, (void *)-6), (void *)-2);
+
+    /* Full scans in both directions */
+    EXPECT_EQ_INT(bptree_iter_init(&it, &t), 0);
+    prev = INTPTR_MIN;
+    for (i = 0; bptree_iter_get(&it, &k, NULL) == 0; i++) {
+      EXPECT_GT_INT((intptr_t)k, prev);
+      prev = (intptr_t)k;
+      bptree_iter_inc(&it);
+    }
+    EXPECT_EQ_INT(i, 500);
+    EXPECT_EQ_INT(bptree_iter_rinit(&it, &t), 0);
+    for (i = 0; bptree_iter_get(&it, &k, &v) == 0; i++) {
+      EXPECT_EQ_INT((intptr_t)k, (intptr_t)v * 3);
+      bptree_iter_dec(&it);
+    }
+    EXPECT_EQ_INT(i, 500);
+
+    /* Seek lands on the lower bound and crosses leaves */
+    EXPECT_EQ_INT(bptree_iter_seek(&it, &t, (void *)-1), 0);
+    EXPECT_EQ_INT(bptree_iter_get(&it, &k, NULL), 0);
+    EXPECT_EQ_INT((intptr_t)k, 0);
+    bptree_iter_dec(&it);
+    EXPECT_EQ_INT(bptree_iter_get(&it, &k, NULL), 0);
+    EXPECT_EQ_INT((intptr_t)k, -6);
+    EXPECT_EQ_INT(bptree_iter_seek(&it, &t, (void *)1494), 0);
+    EXPECT_EQ_INT(bptree_iter_get(&it, &k, NULL), 0);
+    EXPECT_EQ_INT((intptr_t)k, 1494);
+    bptree_iter_inc(&it);
+    EXPECT_EQ_INT(bptree_iter_get(&it, &k, NULL), -1);
+    EXPECT_EQ_INT(bptree_iter_seek(&it, &t, (void *)-10000), 0);
+    EXPECT_EQ_INT(bptree_iter_get(&it, &k, NULL), 0);
+    EXPECT_EQ_INT((intptr_t)k, -1500);
+
+    for (i = -500; i < 500; i += 2)
+      EXPECT_EQ_INT(bptree_remove(&t, (void *)(i * 3), NULL), 0);
+    EXPECT_TRUE(bptree_empty(&t));
+    EXPECT_NULL(t.root);
+    bptree_fini(&t);
+  }
+}
@@ -0,0 +1,111 @@
+#include <bptree.h>
+#include <stdlib.h>
+#include <utest.h>
+
+/* Keys are heap copies freed by the tree, so a separator left pointing at a
+   removed key shows up as a use after free */
+static int *mkkey(int v)
+{
+  int *p = malloc(sizeof *p);
+  if (p)
+    *p = v;
+  return p;
+}
+
+/* Depth of the leaves under node, or -1 if the fill, key order, separators or
+   leaf depths are off. lo is the smallest key the subtree must hold. */
+static int check(struct bptree_node *node, int root, void *lo,
+                 void **first)
+{
+  int i;
+  if (node->n > BPTREE_ORDER || (!root && node->n < BPTREE_ORDER / 2))
+    return -1;
+  for (i = 1; i < node->n; i++)
+    if (cmp_int(node->keys[i - 1], node->keys[i]) >= 0)
+      return -1;
+  if (node->leaf) {
+    *first = node->keys[0];
+    return lo && node->keys[0] != lo ? -1 : 0;
+  }
+  if (root && node->n < 1)
+    return -1;
+  int depth = -1;
+  for (i = 0; i <= node->n; i++) {
+    void *min;
+    int d = check(node->child[i], 0, i ? node->keys[i - 1] : NULL, &min);
+    if (d < 0 || (depth >= 0 && d != depth))
+      return -1;
+    if (i == 0) {
+      *first = min;
+      if (lo && min != lo)
+        return -1;
+    }
+    depth = d;
+  }
+  return depth + 1;
+}
+
+UTEST_CASE(integration)
+{
+  struct bptree t;
+  struct bptree_fns fns = {cmp_int, free, NULL};
+  struct bptree_iter it;
+  static char in[6000];
+  unsigned seed = 3u;
+  size_t live = 0;
+  void *k, *first;
+  int i, round, probe, prev;
+
+  EXPECT_EQ_INT(bptree_init(&t, &fns), 0);
+  for (round = 0; round < 60000; round++) {
+    seed = seed * 1103515245u + 12345u;
+    int v = (int)((seed >> 16) % 6000);
+    /* Grow for the first half, then shrink */
+    int grow = round < 30000 ? (seed >> 8) % 4 != 0 : (seed >> 8) % 4 == 0;
+    if (in[v] && !grow) {
+      EXPECT_EQ_INT(bptree_remove(&t, &v, NULL), 0);
+      in[v] = 0;
+      live--;
+    } else if (!in[v] && grow) {
+      int *key = mkkey(v);
+      EXPECT_NOTNULL(key);
+      EXPECT_EQ_INT(bptree_insert(&t, key, NULL), 0);
+      in[v] = 1;
+      live++;
+    }
+    if (round % 4999)
+      continue;
+    EXPECT_EQ_UINT(bptree_size(&t), live);
+    if (t.root)
+      EXPECT_GE_INT(check(t.root, 1, NULL, &first), 0);
+  }
+
+  /* The leaf chain yields exactly the live keys in order */
+  EXPECT_EQ_INT(bptree_iter_init(&it, &t), 0);
+  prev = -1;
+  for (i = 0; i < 6000; i++) {
+    if (!in[i])
+      continue;
+    EXPECT_EQ_INT(bptree_iter_get(&it, &k, NULL), 0);
+    EXPECT_EQ_INT(*(int *)k, i);
+    EXPECT_GT_INT(*(int *)k, prev);
+    prev = *(int *)k;
+    bptree_iter_inc(&it);
+  }
+  EXPECT_EQ_INT(bptree_iter_get(&it, &k, NULL), -1);
+
+  for (probe = 0; probe < 6000; probe++)
+    EXPECT_EQ_INT(bptree_contains(&t, &probe), in[probe]);
+
+  /* Drain in ascending order, always removing the first key of a leaf */
+  for (probe = 0; probe < 6000; probe++)
+    if (in[probe])
+      EXPECT_EQ_INT(bptree_remove(&t, &probe, NULL), 0);
+  EXPECT_TRUE(bptree_empty(&t));
+  EXPECT_NULL(t.root);
+
+  for (i = 0; i < 3000; i++)
+    EXPECT_EQ_INT(bptree_insert(&t, mkkey(i), NULL), 0);
+  EXPECT_GE_INT(check(t.root, 1, NULL, &first), 2);
+  bptree_fini(&t);
+}
@@ -0,0 +1,88 @@
+#include <bqueue.h>
+#include <errno.h>
+#include <time.h>
+#include <utest.h>
+
+static int bqueue_dtor_n;
+static void bqueue_dtor_inc(void *p)
+{
+  (void)p;
+  bqueue_dtor_n++;
+}
+
+UTEST_CASE(basic)
+{
+  {
+    struct bqueue bq;
+    int x = 0, out[8], i;
+
+    EXPECT_EQ_INT(bqueue_init(NULL, sizeof(int), 0, NULL), -1);
+    EXPECT_EQ_INT(bqueue_init(&bq, 0, 0, NULL), -1);
+    EXPECT_EQ_INT(bqueue_init(&bq, sizeof(int), 0, NULL), 0);
+    EXPECT_EQ_UINT(bqueue_capacity(&bq), 0);
+    EXPECT_EQ_INT(bqueue_enq(&bq, NULL), -1);
+    for (i = 0; i < 100; i++)
+      EXPECT_EQ_INT(bqueue_enq(&bq, &i), 0);
+    EXPECT_EQ_UINT(bqueue_size(&bq), 100);
+    EXPECT_EQ_INT(bqueue_deq(&bq, &x), 0);
+    EXPECT_EQ_INT(x, 0);
+    EXPECT_EQ_INT(bqueue_deq_timeout(&bq, &x, 0), 0);
+    EXPECT_EQ_INT(x, 1);
+    EXPECT_EQ_UINT(bqueue_drain_n(&bq, out, 8), 8);
+    for (i = 0; i < 8; i++)
+      EXPECT_EQ_INT(out[i], i + 2);
+    EXPECT_EQ_UINT(bqueue_size(&bq), 90);
+    bqueue_fini(&bq);
+  }
+
+  {
+    struct bqueue bq;
+    struct timespec t0, t1;
+    long ms;
+    int x = 5;
+
+    /* The timeout runs on the monotonic clock */
+    EXPECT_EQ_INT(bqueue_init(&bq, sizeof(int), 4, NULL), 0);
+    errno = 0;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    EXPECT_EQ_INT(bqueue_deq_timeout(&bq, &x, 20), -1);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    EXPECT_EQ_INT(errno, ETIMEDOUT);
+    ms = (long)(t1.tv_sec - t0.tv_sec) * 1000 +
+         (t1.tv_nsec - t0.tv_nsec) / 1000000;
+    EXPECT_GE_INT(ms, 20);
+    EXPECT_EQ_INT(bqueue_enq(&bq, &x), 0);
+    x = 6;
+    EXPECT_EQ_INT(bqueue_enq(&bq, &x), 0);
+
+    /* Closing refuses pushes but lets consumers drain what is left */
+    bqueue_close(&bq);
+    errno = 0;
+    EXPECT_EQ_INT(bqueue_enq(&bq, &x), -1);
+    EXPECT_EQ_INT(errno, EPIPE);
+    EXPECT_EQ_INT(bqueue_deq(&bq, &x), 0);
+    EXPECT_EQ_INT(x, 5);
+    EXPECT_EQ_INT(bqueue_deq_timeout(&bq, &x, 1000), 0);
+    EXPECT_EQ_INT(x, 6);
+    errno = 0;
+    EXPECT_EQ_INT(bqueue_deq(&bq, &x), -1);
+    EXPECT_EQ_INT(errno, EPIPE);
+    EXPECT_EQ_INT(bqueue_deq_timeout(&bq, &x, 1000), -1);
+    EXPECT_EQ_UINT(bqueue_drain_n(&bq, &x, 1), 0);
+    bqueue_fini(&bq);
+  }
+
+  {
+    struct bqueue bq;
+    int x = 1;
+
+    bqueue_dtor_n = 0;
+    EXPECT_EQ_INT(bqueue_init(&bq, sizeof(int), 0, bqueue_dtor_inc), 0);
+    EXPECT_EQ_INT(bqueue_enq(&bq, &x), 0);
+    EXPECT_EQ_INT(bqueue_enq(&bq, &x), 0);
+    EXPECT_EQ_INT(bqueue_deq(&bq, NULL), 0);
+    EXPECT_EQ_INT(bqueue_dtor_n, 1);
+    bqueue_fini(&bq);
+    EXPECT_EQ_INT(bqueue_dtor_n, 2);
+  }
+}
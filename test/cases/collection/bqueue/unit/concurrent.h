@@ -0,0 +1,110 @@
+#include <bqueue.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <utest.h>
+
+#define BQUEUE_NPROD 3
+#define BQUEUE_NCONS 3
+#define BQUEUE_NITEM 20000
+
+struct bqueue_worker {
+  struct bqueue *bq;
+  int id;
+  int64_t sum;
+  size_t cnt;
+  int failed;
+};
+
+static void *bqueue_produce(void *arg)
+{
+  struct bqueue_worker *w = arg;
+  for (int i = 0; i < BQUEUE_NITEM; i++) {
+    int x = w->id * BQUEUE_NITEM + i;
+    if (bqueue_enq(w->bq, &x) == -1)
+      w->failed = 1;
+  }
+  return NULL;
+}
+
+/* Consumers alternate between single pops and batches until closed */
+static void *bqueue_consume(void *arg)
+{
+  struct bqueue_worker *w = arg;
+  int buf[16];
+  size_t n, i;
+
+  for (;;) {
+    if (w->id == 0) {
+      if (bqueue_deq(w->bq, buf) == -1)
+        break;
+      n = 1;
+    } else if (w->id == 1) {
+      if (bqueue_deq_timeout(w->bq, buf, 5) == -1) {
+        if (errno == ETIMEDOUT)
+          continue;
+        break;
+      }
+      n = 1;
+    } else if (!(n = bqueue_drain_n(w->bq, buf, 16)))
+      break;
+    for (i = 0; i < n; i++)
+      w->sum += buf[i];
+    w->cnt += n;
+  }
+  return NULL;
+}
+
+UTEST_CASE(concurrent)
+{
+  {
+    /* A small bounded queue forces producers to block on backpressure */
+    struct bqueue bq;
+    struct bqueue_worker prod[BQUEUE_NPROD], cons[BQUEUE_NCONS];
+    pthread_t tprod[BQUEUE_NPROD], tcons[BQUEUE_NCONS];
+    int64_t sum = 0, n = (int64_t)BQUEUE_NPROD * BQUEUE_NITEM;
+    size_t cnt = 0;
+    int i;
+
+    EXPECT_EQ_INT(bqueue_init(&bq, sizeof(int), 16, NULL), 0);
+    for (i = 0; i < BQUEUE_NCONS; i++) {
+      cons[i] = (struct bqueue_worker){&bq, i, 0, 0, 0};
+      EXPECT_EQ_INT(pthread_create(&tcons[i], NULL, bqueue_consume, &cons[i]),
+                    0);
+    }
+    for (i = 0; i < BQUEUE_NPROD; i++) {
+      prod[i] = (struct bqueue_worker){&bq, i, 0, 0, 0};
+      EXPECT_EQ_INT(pthread_create(&tprod[i], NULL, bqueue_produce, &prod[i]),
+                    0);
+    }
+    for (i = 0; i < BQUEUE_NPROD; i++) {
+      pthread_join(tprod[i], NULL);
+      EXPECT_EQ_INT(prod[i].failed, 0);
+    }
+    bqueue_close(&bq);
+    for (i = 0; i < BQUEUE_NCONS; i++) {
+      pthread_join(tcons[i], NULL);
+      sum += cons[i].sum;
+      cnt += cons[i].cnt;
+    }
+    EXPECT_EQ_UINT(cnt, (size_t)n);
+    EXPECT_EQ_INT(sum, n * (n - 1) / 2);
+    EXPECT_EQ_UINT(bqueue_size(&bq), 0);
+    bqueue_fini(&bq);
+  }
+
+  {
+    /* Closing wakes a consumer sleeping on an empty queue */
+    struct bqueue bq;
+    struct bqueue_worker w;
+    pthread_t t;
+
+    EXPECT_EQ_INT(bqueue_init(&bq, sizeof(int), 0, NULL), 0);
+    w = (struct bqueue_worker){&bq, 0, 0, 0, 0};
+    EXPECT_EQ_INT(pthread_create(&t, NULL, bqueue_consume, &w), 0);
+    bqueue_close(&bq);
+    pthread_join(t, NULL);
+    EXPECT_EQ_UINT(w.cnt, 0);
+    bqueue_fini(&bq);
+  }
+}
@@ -2,6 +2,7 @@
 #include "unit/edge.h"
 #include "unit/integration.h"
 #include "unit/iter.h"
+#include "unit/span.h"
 
 UTEST_SUITE(deque)
 {
@@ -9,4 +10,5 @@ UTEST_SUITE(deque)
   UTEST_RUNCASE(edge);
   UTEST_RUNCASE(integration);
   UTEST_RUNCASE(iter);
+  UTEST_RUNCASE(span);
 }
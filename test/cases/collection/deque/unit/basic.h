@@ -208,6 +208,31 @@ UTEST_CASE(basic)
     deq_fini(&d);
   }
 
+  {
+    struct deque d;
+    size_t cap;
+
+    EXPECT_EQ_INT(deq_init(&d, sizeof(int), NULL), 0);
+    EXPECT_EQ_INT(deq_reserve(&d, 0), 0);
+    EXPECT_EQ_UINT(deq_size(&d), 0);
+    EXPECT_EQ_INT(deq_reserve(&d, 100), 0);
+    EXPECT_EQ_UINT(deq_size(&d), 0);
+    EXPECT_GE_UINT(deq_capacity(&d), 100);
+    cap = deq_capacity(&d);
+    EXPECT_EQ_INT(deq_reserve(&d, 50), 0);
+    EXPECT_EQ_UINT(deq_capacity(&d), cap);
+    /* Elements survive the move, including ones that wrapped */
+    for (int i = 0; i < 3; i++)
+      EXPECT_EQ_INT(deq_pushfront(&d, &i), 0);
+    EXPECT_EQ_INT(deq_reserve(&d, cap + 1), 0);
+    EXPECT_GE_UINT(deq_capacity(&d), cap + 1);
+    EXPECT_EQ_UINT(deq_size(&d), 3);
+    for (int i = 0; i < 3; i++)
+      EXPECT_EQ_INT(*(int *)deq_at(&d, (size_t)i), 2 - i);
+    EXPECT_EQ_INT(deq_reserve(NULL, 1), -1);
+    deq_fini(&d);
+  }
+
   {
     struct deque d;
     size_t cap_a, cap_b;
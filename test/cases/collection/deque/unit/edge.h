@@ -349,4 +349,104 @@ UTEST_CASE(edge)
     EXPECT_EQ_INT(*(int *)deq_at(&d, 0), 2);
     deq_fini(&d);
   }
+
+  {
+    /* Capacity stays a power of two through growth, resize and shrink */
+    struct deque d;
+    int i, x;
+
+    EXPECT_EQ_INT(deq_init(&d, sizeof(int), NULL), 0);
+    EXPECT_EQ_INT(deq_resize(&d, 100), 0);
+    EXPECT_EQ_UINT(deq_capacity(&d), 128);
+    EXPECT_EQ_INT(deq_resize(&d, 5), 0);
+    EXPECT_EQ_INT(deq_shrink(&d), 0);
+    EXPECT_EQ_UINT(deq_capacity(&d), 8);
+    for (i = 0; i < 5; i++)
+      *(int *)deq_at(&d, (size_t)i) = i;
+    for (i = 5; i < 40; i++) {
+      x = i;
+      EXPECT_EQ_INT(i % 2 ? deq_pushback(&d, &x) : deq_pushfront(&d, &x), 0);
+      EXPECT_EQ_UINT(deq_capacity(&d) & (deq_capacity(&d) - 1), 0);
+    }
+    EXPECT_EQ_UINT(deq_capacity(&d), 64);
+    for (i = 0; i < 30; i++)
+      EXPECT_EQ_INT(deq_popfront(&d, NULL), 0);
+    EXPECT_EQ_INT(deq_shrink(&d), 0);
+    EXPECT_EQ_UINT(deq_size(&d), 10);
+    EXPECT_EQ_UINT(deq_capacity(&d), 16);
+    x = 99;
+    EXPECT_EQ_INT(deq_pushfront(&d, &x), 0);
+    EXPECT_EQ_INT(*(int *)deq_front(&d), 99);
+    EXPECT_EQ_INT(*(int *)deq_at(&d, 1), 21);
+    EXPECT_EQ_INT(*(int *)deq_back(&d), 39);
+    deq_fini(&d);
+  }
+
+  {
+    /* Growing within capacity zeroes the new slots, also across the wrap */
+    struct deque d;
+    size_t cap, i;
+    int x = 7;
+
+    EXPECT_EQ_INT(deq_init(&d, sizeof(int), NULL), 0);
+    for (i = 0; i < 8; i++)
+      EXPECT_EQ_INT(deq_pushback(&d, &x), 0);
+    cap = deq_capacity(&d);
+    for (i = 0; i < 5; i++)
+      EXPECT_EQ_INT(deq_popfront(&d, NULL), 0);
+    EXPECT_EQ_INT(deq_resize(&d, 1), 0);
+    EXPECT_EQ_INT(deq_resize(&d, cap), 0);
+    EXPECT_EQ_UINT(deq_capacity(&d), cap);
+    EXPECT_EQ_INT(*(int *)deq_at(&d, 0), 7);
+    for (i = 1; i < cap; i++)
+      EXPECT_EQ_INT(*(int *)deq_at(&d, i), 0);
+    deq_fini(&d);
+  }
+
+  {
+    /* Insert and remove at every index for every head position of a wrapped
+       buffer, one slot short of full so no expand linearizes it, against an
+       array */
+    struct deque d;
+    int ref[32], i, k, n, x;
+    size_t cap, j;
+
+    EXPECT_EQ_INT(deq_init(&d, sizeof(int), NULL), 0);
+    for (i = 0; i < 15; i++)
+      EXPECT_EQ_INT(deq_pushback(&d, &i), 0);
+    cap = deq_capacity(&d);
+    deq_fini(&d);
+    EXPECT_EQ_UINT(cap, 16);
+
+    for (i = 0; i < 16; i++) {
+      for (k = 1; k < 15; k++) {
+        EXPECT_EQ_INT(deq_init(&d, sizeof(int), NULL), 0);
+        for (n = 0; n < 15; n++) {
+          ref[n] = n;
+          EXPECT_EQ_INT(deq_pushback(&d, &ref[n]), 0);
+        }
+        for (n = 0; n < i; n++) {
+          EXPECT_EQ_INT(deq_popfront(&d, NULL), 0);
+          x = 100 + n;
+          EXPECT_EQ_INT(deq_pushback(&d, &x), 0);
+        }
+        for (n = 0; n < 15; n++)
+          ref[n] = *(int *)deq_at(&d, (size_t)n);
+        x = -1;
+        EXPECT_EQ_INT(deq_insert(&d, (size_t)k, &x), 0);
+        memmove(ref + k + 1, ref + k, (size_t)(15 - k) * sizeof(int));
+        ref[k] = x;
+        EXPECT_EQ_UINT(deq_size(&d), 16);
+        EXPECT_EQ_UINT(deq_capacity(&d), cap);
+        for (j = 0; j < 16; j++)
+          EXPECT_EQ_INT(*(int *)deq_at(&d, j), ref[j]);
+        EXPECT_EQ_INT(deq_remove(&d, (size_t)k, &x), 0);
+        EXPECT_EQ_INT(x, -1);
+        memmove(ref + k, ref + k + 1, (size_t)(15 - k) * sizeof(int));
+        for (j = 0; j < 15; j++)
+          EXPECT_EQ_INT(*(int *)deq_at(&d, j), ref[j]);
+        deq_fini(&d);
+      }
+    }
+  }
 }
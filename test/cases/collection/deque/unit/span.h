@@ -0,0 +1,86 @@
+#include <deque.h>
+#include <utest.h>
+
+static int span_dtor_n;
+static void span_dtor_inc(void *p)
+{
+  (void)p;
+  span_dtor_n++;
+}
+
+UTEST_CASE(span)
+{
+  {
+    struct deque d;
+    void *a, *b;
+    size_t alen, blen;
+    int x = 0;
+
+    EXPECT_EQ_INT(deq_init(&d, sizeof(int), NULL), 0);
+    EXPECT_EQ_INT(deq_pushback_n(NULL, &x, 1), -1);
+    EXPECT_EQ_INT(deq_pushback_n(&d, NULL, 1), -1);
+    EXPECT_EQ_INT(deq_pushback_n(&d, NULL, 0), 0);
+    EXPECT_EQ_INT(deq_popfront_n(&d, &x, 1), -1);
+    EXPECT_EQ_INT(deq_popfront_n(&d, NULL, 0), 0);
+    EXPECT_EQ_INT(deq_spans(&d, &a, &alen, NULL, &blen), -1);
+    EXPECT_EQ_INT(deq_spans(&d, &a, &alen, &b, &blen), 0);
+    EXPECT_NULL(a);
+    EXPECT_NULL(b);
+    EXPECT_EQ_UINT(alen + blen, 0);
+    deq_fini(&d);
+  }
+
+  {
+    /* Wrapped layout: spans cover the elements in order */
+    struct deque d;
+    int in[40], out[40], i;
+    void *a, *b;
+    size_t alen, blen;
+
+    for (i = 0; i < 40; i++)
+      in[i] = i;
+    EXPECT_EQ_INT(deq_init(&d, sizeof(int), NULL), 0);
+    EXPECT_EQ_INT(deq_pushback_n(&d, in, 12), 0);
+    EXPECT_EQ_UINT(deq_capacity(&d), 16);
+    EXPECT_EQ_INT(deq_popfront_n(&d, out, 10), 0);
+    for (i = 0; i < 10; i++)
+      EXPECT_EQ_INT(out[i], i);
+    EXPECT_EQ_INT(deq_pushback_n(&d, in + 12, 10), 0);
+    EXPECT_EQ_UINT(deq_capacity(&d), 16);
+    EXPECT_EQ_INT(deq_spans(&d, &a, &alen, &b, &blen), 0);
+    EXPECT_EQ_UINT(alen, 6);
+    EXPECT_EQ_UINT(blen, 6);
+    EXPECT_EQ_PTR(b, d.buf);
+    for (i = 0; i < 6; i++) {
+      EXPECT_EQ_INT(((int *)a)[i], 10 + i);
+      EXPECT_EQ_INT(((int *)b)[i], 16 + i);
+    }
+
+    /* Growing while wrapped keeps the order */
+    EXPECT_EQ_INT(deq_pushback_n(&d, in + 22, 18), 0);
+    EXPECT_EQ_UINT(deq_size(&d), 30);
+    EXPECT_EQ_INT(deq_spans(&d, &a, &alen, &b, &blen), 0);
+    EXPECT_EQ_UINT(alen, 30);
+    EXPECT_NULL(b);
+    EXPECT_EQ_INT(deq_popfront_n(&d, out, 30), 0);
+    for (i = 0; i < 30; i++)
+      EXPECT_EQ_INT(out[i], 10 + i);
+    EXPECT_TRUE(deq_empty(&d));
+    deq_fini(&d);
+  }
+
+  {
+    struct deque d;
+    int in[8] = {0};
+
+    span_dtor_n = 0;
+    EXPECT_EQ_INT(deq_init(&d, sizeof(int), span_dtor_inc), 0);
+    EXPECT_EQ_INT(deq_pushback_n(&d, in, 8), 0);
+    EXPECT_EQ_INT(deq_popfront_n(&d, NULL, 5), 0);
+    EXPECT_EQ_INT(span_dtor_n, 5);
+    EXPECT_EQ_INT(deq_popfront_n(&d, NULL, 4), -1);
+    EXPECT_EQ_UINT(deq_size(&d), 3);
+    deq_fini(&d);
+    EXPECT_EQ_INT(span_dtor_n, 8);
+  }
+}
@@ -1,5 +1,6 @@
 #include "unit/basic.h"
 #include "unit/edge.h"
+#include "unit/indexed.h"
 #include "unit/integration.h"
 
 UTEST_SUITE(heap)
@@ -7,4 +8,5 @@ UTEST_SUITE(heap)
   UTEST_RUNCASE(basic);
   UTEST_RUNCASE(edge);
   UTEST_RUNCASE(integration);
+  UTEST_RUNCASE(indexed);
 }
\ No newline at end of file
@@ -376,4 +376,33 @@ UTEST_CASE(basic)
     heap_fini(&h);
     EXPECT_EQ_INT(dtor_n, 3);
   }
+
+  {
+    struct heap h;
+    int x, out, prev;
+    int vals[] = {5, 1, 9, 3, 7, 9, 2, 8, 6, 4};
+    size_t i;
+
+    dtor_n = 0;
+    EXPECT_EQ_INT(heap_init(&h, sizeof(int), cmp_int, dtor_inc), 0);
+    x = 1;
+    EXPECT_EQ_INT(heap_topk(NULL, &x, 3), -1);
+    EXPECT_EQ_INT(heap_topk(&h, NULL, 3), -1);
+    EXPECT_EQ_INT(heap_topk(&h, &x, 0), -1);
+    for (i = 0; i < sizeof(vals) / sizeof(vals[0]); i++)
+      EXPECT_NE_INT(heap_topk(&h, &vals[i], 3), -1);
+    EXPECT_EQ_UINT(heap_size(&h), 3);
+    x = 0;
+    EXPECT_EQ_INT(heap_topk(&h, &x, 3), 1);
+    EXPECT_EQ_INT(*(int *)heap_peek(&h), 8);
+    prev = 0;
+    for (i = 0; i < 3; i++) {
+      EXPECT_EQ_INT(heap_pop(&h, &out), 0);
+      EXPECT_GE_INT(out, prev);
+      prev = out;
+    }
+    EXPECT_EQ_INT(prev, 9);
+    EXPECT_EQ_INT(dtor_n, 4);
+    heap_fini(&h);
+  }
 }
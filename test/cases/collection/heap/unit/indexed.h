@@ -0,0 +1,161 @@
+#include <heap.h>
+#include <utest.h>
+
+struct idx_item {
+  int key;
+  int id;
+};
+
+static int idx_cmp(void *a, void *b)
+{
+  int x = ((struct idx_item *)a)->key;
+  int y = ((struct idx_item *)b)->key;
+  return (x > y) - (x < y);
+}
+
+static int idx_dtor_n;
+static void idx_dtor_inc(void *p)
+{
+  (void)p;
+  idx_dtor_n++;
+}
+
+UTEST_CASE(indexed)
+{
+  {
+    struct iheap ih;
+    struct idx_item it = {1, 1};
+    size_t h;
+
+    EXPECT_EQ_INT(iheap_init(NULL, sizeof(it), idx_cmp, NULL), -1);
+    EXPECT_EQ_INT(iheap_init(&ih, 0, idx_cmp, NULL), -1);
+    EXPECT_EQ_INT(iheap_init(&ih, sizeof(it), NULL, NULL), -1);
+    EXPECT_EQ_INT(iheap_init(&ih, sizeof(it), idx_cmp, NULL), 0);
+    EXPECT_TRUE(iheap_empty(&ih));
+    EXPECT_NULL(iheap_peek(&ih));
+    EXPECT_EQ_INT(iheap_pop(&ih, NULL), -1);
+    EXPECT_EQ_INT(iheap_update(&ih, 0), -1);
+    EXPECT_EQ_INT(iheap_erase(&ih, 0, NULL), -1);
+    EXPECT_NULL(iheap_get(&ih, 0));
+    EXPECT_EQ_INT(iheap_push(&ih, NULL, &h), -1);
+    EXPECT_EQ_INT(iheap_push(&ih, &it, &h), 0);
+    EXPECT_EQ_UINT(iheap_size(&ih), 1);
+    EXPECT_EQ_INT(((struct idx_item *)iheap_get(&ih, h))->id, 1);
+    EXPECT_EQ_INT(iheap_erase(&ih, h, NULL), 0);
+    EXPECT_EQ_INT(iheap_erase(&ih, h, NULL), -1);
+    EXPECT_NULL(iheap_get(&ih, h));
+    EXPECT_TRUE(iheap_empty(&ih));
+    iheap_fini(&ih);
+  }
+
+  {
+    struct iheap ih;
+    struct idx_item it, out;
+    size_t ha, hb, hc;
+
+    idx_dtor_n = 0;
+    EXPECT_EQ_INT(iheap_init(&ih, sizeof(it), idx_cmp, idx_dtor_inc), 0);
+    it = (struct idx_item){10, 0};
+    EXPECT_EQ_INT(iheap_push(&ih, &it, &ha), 0);
+    it = (struct idx_item){20, 1};
+    EXPECT_EQ_INT(iheap_push(&ih, &it, &hb), 0);
+    it = (struct idx_item){30, 2};
+    EXPECT_EQ_INT(iheap_push(&ih, &it, &hc), 0);
+
+    /* decrease-key moves c to the top, increase-key sinks a */
+    ((struct idx_item *)iheap_get(&ih, hc))->key = 5;
+    EXPECT_EQ_INT(iheap_update(&ih, hc), 0);
+    EXPECT_EQ_INT(((struct idx_item *)iheap_peek(&ih))->id, 2);
+    ((struct idx_item *)iheap_get(&ih, ha))->key = 50;
+    EXPECT_EQ_INT(iheap_update(&ih, ha), 0);
+
+    EXPECT_EQ_INT(iheap_erase(&ih, hb, &out), 0);
+    EXPECT_EQ_INT(out.id, 1);
+    EXPECT_EQ_INT(iheap_pop(&ih, &out), 0);
+    EXPECT_EQ_INT(out.id, 2);
+    EXPECT_EQ_INT(((struct idx_item *)iheap_get(&ih, ha))->key, 50);
+    EXPECT_EQ_INT(iheap_pop(&ih, NULL), 0);
+    EXPECT_EQ_INT(idx_dtor_n, 1);
+    EXPECT_TRUE(iheap_empty(&ih));
+
+    /* released handles are reused */
+    EXPECT_EQ_INT(iheap_push(&ih, &it, &ha), 0);
+    EXPECT_LT_UINT(ha, 3);
+    iheap_clear(&ih);
+    EXPECT_NULL(iheap_get(&ih, ha));
+    EXPECT_EQ_INT(idx_dtor_n, 2);
+    iheap_fini(&ih);
+  }
+
+  {
+    enum { N = 400 };
+    struct iheap ih;
+    size_t handles[N];
+    int keys[N], alive[N];
+    unsigned seed = 77u;
+    int i, step;
+
+    EXPECT_EQ_INT(iheap_init(&ih, sizeof(struct idx_item), idx_cmp, NULL), 0);
+    for (i = 0; i < N; i++) {
+      struct idx_item it;
+      seed = seed * 1103515245u + 12345u;
+      keys[i] = (int)((seed >> 8) % 1000);
+      alive[i] = 1;
+      it = (struct idx_item){keys[i], i};
+      EXPECT_EQ_INT(iheap_push(&ih, &it, &handles[i]), 0);
+    }
+    for (step = 0; step < 2000; step++) {
+      seed = seed * 1103515245u + 12345u;
+      i = (int)((seed >> 8) % N);
+      if (!alive[i])
+        continue;
+      seed = seed * 1103515245u + 12345u;
+      if ((seed >> 8) % 5 == 0) {
+        EXPECT_EQ_INT(iheap_erase(&ih, handles[i], NULL), 0);
+        alive[i] = 0;
+      } else {
+        keys[i] = (int)((seed >> 12) % 1000);
+        ((struct idx_item *)iheap_get(&ih, handles[i]))->key = keys[i];
+        EXPECT_EQ_INT(iheap_update(&ih, handles[i]), 0);
+      }
+    }
+    while (!iheap_empty(&ih)) {
+      struct idx_item out;
+      int min = 1000;
+      for (i = 0; i < N; i++) {
+        if (alive[i] && keys[i] < min)
+          min = keys[i];
+      }
+      EXPECT_EQ_INT(iheap_pop(&ih, &out), 0);
+      EXPECT_EQ_INT(out.key, min);
+      EXPECT_EQ_INT(keys[out.id], out.key);
+      EXPECT_TRUE(alive[out.id]);
+      alive[out.id] = 0;
+    }
+    iheap_fini(&ih);
+  }
+
+  {
+    struct iheap ih;
+    struct idx_item it;
+    size_t cap, grows = 0;
+    int i;
+
+    /* The handle table grows geometrically like the element buffer */
+    EXPECT_EQ_INT(iheap_init(&ih, sizeof(it), idx_cmp, NULL), 0);
+    cap = vec_capacity(&ih.hnd);
+    for (i = 0; i < 1024; i++) {
+      it.key = 1024 - i;
+      it.id = i;
+      EXPECT_EQ_INT(iheap_push(&ih, &it, NULL), 0);
+      if (vec_capacity(&ih.hnd) != cap) {
+        cap = vec_capacity(&ih.hnd);
+        grows++;
+      }
+    }
+    EXPECT_EQ_UINT(vec_size(&ih.hnd), 1024);
+    EXPECT_LE_UINT(grows, 12);
+    EXPECT_EQ_INT(((struct idx_item *)iheap_peek(&ih))->id, 1023);
+    iheap_fini(&ih);
+  }
+}
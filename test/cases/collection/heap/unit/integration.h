@@ -676,4 +676,134 @@ UTEST_CASE(integration)
     EXPECT_TRUE(heap_empty(&h));
     heap_fini(&h);
   }
+
+  {
+    size_t arities[] = {2, 4, 8};
+    size_t a;
+
+    for (a = 0; a < sizeof(arities) / sizeof(arities[0]); a++) {
+      struct heap h;
+      unsigned seed = 12345u;
+      int i, x, out, prev;
+
+      EXPECT_EQ_INT(heap_init_arity(&h, sizeof(int), arities[a],
+                                    intg_cmp_min_int, NULL),
+                    0);
+      EXPECT_EQ_UINT(h.arity, arities[a]);
+      for (i = 0; i < 1000; i++) {
+        seed = seed * 1103515245u + 12345u;
+        x = (int)((seed >> 8) % 500);
+        EXPECT_EQ_INT(heap_push(&h, &x), 0);
+        if (i % 3 == 2)
+          EXPECT_EQ_INT(heap_pop(&h, NULL), 0);
+      }
+      prev = -1;
+      while (!heap_empty(&h)) {
+        EXPECT_EQ_INT(heap_pop(&h, &out), 0);
+        EXPECT_GE_INT(out, prev);
+        prev = out;
+      }
+      heap_fini(&h);
+    }
+  }
+
+  {
+    struct heap h;
+
+    EXPECT_EQ_INT(heap_init_arity(&h, sizeof(int), 3, intg_cmp_min_int, NULL),
+                  -1);
+    EXPECT_EQ_INT(heap_init_arity(&h, sizeof(int), 0, intg_cmp_min_int, NULL),
+                  -1);
+    EXPECT_EQ_INT(heap_init(&h, sizeof(int), intg_cmp_min_int, NULL), 0);
+    EXPECT_EQ_UINT(h.arity, 4);
+    heap_fini(&h);
+    EXPECT_EQ_INT(heap_init(&h, 48, intg_cmp_min_int, NULL), 0);
+    EXPECT_EQ_UINT(h.arity, 2);
+    heap_fini(&h);
+  }
+
+  {
+    struct heap h;
+    int buf[300];
+    int more[40];
+    int i, out, prev;
+
+    EXPECT_EQ_INT(heap_init_from(&h, NULL, 3, sizeof(int), intg_cmp_min_int,
+                                 NULL),
+                  -1);
+    for (i = 0; i < 300; i++)
+      buf[i] = (i * 7919) % 300;
+    EXPECT_EQ_INT(heap_init_from(&h, buf, 300, sizeof(int), intg_cmp_min_int,
+                                 NULL),
+                  0);
+    EXPECT_EQ_UINT(heap_size(&h), 300);
+    EXPECT_EQ_INT(*(int *)heap_peek(&h), 0);
+
+    /* A small batch is sifted up, a large one triggers a heapify */
+    for (i = 0; i < 20; i++)
+      more[i] = -i;
+    EXPECT_EQ_INT(heap_push_bulk(&h, more, 20), 0);
+    EXPECT_EQ_INT(*(int *)heap_peek(&h), -19);
+    EXPECT_EQ_INT(heap_push_bulk(&h, more, 0), 0);
+    EXPECT_EQ_INT(heap_push_bulk(&h, NULL, 2), -1);
+    EXPECT_EQ_INT(heap_push_bulk(&h, buf, 300), 0);
+    EXPECT_EQ_UINT(heap_size(&h), 620);
+
+    out = 0;
+    i = 1000;
+    EXPECT_EQ_INT(heap_replace_top(&h, &i, &out), 0);
+    EXPECT_EQ_INT(out, -19);
+    EXPECT_EQ_INT(*(int *)heap_peek(&h), -18);
+    EXPECT_EQ_UINT(heap_size(&h), 620);
+
+    prev = -1000;
+    while (!heap_empty(&h)) {
+      EXPECT_EQ_INT(heap_pop(&h, &out), 0);
+      EXPECT_GE_INT(out, prev);
+      prev = out;
+    }
+    EXPECT_EQ_INT(prev, 1000);
+    EXPECT_EQ_INT(heap_replace_top(&h, &i, &out), -1);
+    heap_fini(&h);
+  }
+
+  {
+    struct heap h;
+    size_t cap, grows = 0;
+    int i;
+
+    /* Repeated small batches grow the buffer geometrically */
+    EXPECT_EQ_INT(heap_init(&h, sizeof(int), intg_cmp_min_int, NULL), 0);
+    cap = vec_capacity(&h.vec);
+    for (i = 0; i < 1024; i++) {
+      EXPECT_EQ_INT(heap_push_bulk(&h, &i, 1), 0);
+      if (vec_capacity(&h.vec) != cap) {
+        cap = vec_capacity(&h.vec);
+        grows++;
+      }
+    }
+    EXPECT_EQ_UINT(heap_size(&h), 1024);
+    EXPECT_LE_UINT(grows, 12);
+    EXPECT_EQ_INT(*(int *)heap_peek(&h), 0);
+    heap_fini(&h);
+  }
+
+  {
+    struct heap h;
+    int x;
+
+    intg_dtor_n = 0;
+    EXPECT_EQ_INT(heap_init_from(&h, NULL, 0, sizeof(int), intg_cmp_min_int,
+                                 intg_dtor_inc),
+                  0);
+    EXPECT_TRUE(heap_empty(&h));
+    x = 5;
+    EXPECT_EQ_INT(heap_push(&h, &x), 0);
+    x = 6;
+    EXPECT_EQ_INT(heap_replace_top(&h, &x, NULL), 0);
+    EXPECT_EQ_INT(intg_dtor_n, 1);
+    EXPECT_EQ_INT(*(int *)heap_peek(&h), 6);
+    heap_fini(&h);
+    EXPECT_EQ_INT(intg_dtor_n, 2);
+  }
 }
@@ -0,0 +1,8 @@
+#include "unit/basic.h"
+#include "unit/concurrent.h"
+
+UTEST_SUITE(mpmcq)
+{
+  UTEST_RUNCASE(basic);
+  UTEST_RUNCASE(concurrent);
+}
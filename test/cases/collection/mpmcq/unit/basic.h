@@ -0,0 +1,89 @@
+#include <mpmcq.h>
+#include <utest.h>
+
+static int mpmcq_dtor_n;
+static void mpmcq_dtor_inc(void *p)
+{
+  (void)p;
+  mpmcq_dtor_n++;
+}
+
+UTEST_CASE(basic)
+{
+  {
+    struct mpmcq q;
+    int x = 1;
+
+    EXPECT_EQ_INT(mpmcq_init(NULL, sizeof(int), 8, NULL), -1);
+    EXPECT_EQ_INT(mpmcq_init(&q, 0, 8, NULL), -1);
+    EXPECT_EQ_INT(mpmcq_init(&q, sizeof(int), 0, NULL), 0);
+    EXPECT_EQ_UINT(mpmcq_capacity(&q), 2);
+    EXPECT_EQ_INT(mpmcq_try_enq(&q, NULL), -1);
+    EXPECT_EQ_INT(mpmcq_try_deq(&q, &x), -1);
+    EXPECT_EQ_UINT(mpmcq_try_deq_n(&q, &x, 1), 0);
+    mpmcq_fini(&q);
+
+    EXPECT_EQ_INT(mpmcq_init(&q, sizeof(int), 5, NULL), 0);
+    EXPECT_EQ_UINT(mpmcq_capacity(&q), 8);
+    mpmcq_fini(&q);
+  }
+
+  {
+    /* FIFO order across several wraps of the ring */
+    struct mpmcq q;
+    int i, x, next = 0, out = 0;
+
+    EXPECT_EQ_INT(mpmcq_init(&q, sizeof(int), 4, NULL), 0);
+    for (i = 0; i < 100; i++) {
+      while (mpmcq_try_enq(&q, &next) == 0)
+        next++;
+      EXPECT_EQ_UINT(mpmcq_size(&q), 4);
+      EXPECT_EQ_INT(mpmcq_try_deq(&q, &x), 0);
+      EXPECT_EQ_INT(x, out++);
+      EXPECT_EQ_INT(mpmcq_try_deq(&q, &x), 0);
+      EXPECT_EQ_INT(x, out++);
+    }
+    while (mpmcq_try_deq(&q, &x) == 0)
+      EXPECT_EQ_INT(x, out++);
+    EXPECT_EQ_INT(out, next);
+    EXPECT_EQ_UINT(mpmcq_size(&q), 0);
+    mpmcq_fini(&q);
+  }
+
+  {
+    /* Batches stop at the first full or empty slot */
+    struct mpmcq q;
+    int in[12], out[12], i;
+
+    for (i = 0; i < 12; i++)
+      in[i] = i * 3;
+    EXPECT_EQ_INT(mpmcq_init(&q, sizeof(int), 8, NULL), 0);
+    EXPECT_EQ_UINT(mpmcq_try_enq_n(&q, in, 5), 5);
+    EXPECT_EQ_UINT(mpmcq_try_enq_n(&q, in + 5, 7), 3);
+    EXPECT_EQ_UINT(mpmcq_try_enq_n(&q, in + 8, 4), 0);
+    EXPECT_EQ_UINT(mpmcq_try_deq_n(&q, out, 6), 6);
+    EXPECT_EQ_UINT(mpmcq_try_enq_n(&q, in + 8, 4), 4);
+    EXPECT_EQ_UINT(mpmcq_try_deq_n(&q, out + 6, 12), 6);
+    EXPECT_EQ_UINT(mpmcq_try_deq_n(&q, out, 1), 0);
+    for (i = 0; i < 12; i++)
+      EXPECT_EQ_INT(out[i], i * 3);
+    mpmcq_fini(&q);
+  }
+
+  {
+    struct mpmcq q;
+    int x = 7;
+
+    mpmcq_dtor_n = 0;
+    EXPECT_EQ_INT(mpmcq_init(&q, sizeof(int), 4, mpmcq_dtor_inc), 0);
+    EXPECT_EQ_INT(mpmcq_try_enq(&q, &x), 0);
+    EXPECT_EQ_INT(mpmcq_try_enq(&q, &x), 0);
+    EXPECT_EQ_INT(mpmcq_try_enq(&q, &x), 0);
+    EXPECT_EQ_INT(mpmcq_try_deq(&q, NULL), 0);
+    EXPECT_EQ_INT(mpmcq_dtor_n, 1);
+    EXPECT_EQ_INT(mpmcq_try_deq(&q, &x), 0);
+    EXPECT_EQ_INT(mpmcq_dtor_n, 1);
+    mpmcq_fini(&q);
+    EXPECT_EQ_INT(mpmcq_dtor_n, 2);
+  }
+}
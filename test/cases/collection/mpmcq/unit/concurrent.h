@@ -0,0 +1,108 @@
+#include <mpmcq.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <utest.h>
+
+#define MPMCQ_NPROD 4
+#define MPMCQ_NCONS 4
+#define MPMCQ_NITEM 20000
+
+struct mpmcq_worker {
+  struct mpmcq *q;
+  atomic_size_t *left; /* Items not yet consumed */
+  uint64_t id;
+  uint64_t sum;
+  int ordered; /* Items of each producer were seen in order */
+};
+
+/* Items are (producer << 32 | seq), pushed one by one or in batches */
+static void *mpmcq_produce(void *arg)
+{
+  struct mpmcq_worker *w = arg;
+  uint64_t batch[8];
+  size_t i = 0, k, n;
+
+  while (i < MPMCQ_NITEM) {
+    n = (i % 3 == 0) ? 1 : 8;
+    if (n > MPMCQ_NITEM - i)
+      n = MPMCQ_NITEM - i;
+    for (k = 0; k < n; k++)
+      batch[k] = w->id << 32 | (i + k);
+    k = 0;
+    while (k < n) {
+      size_t m = mpmcq_try_enq_n(w->q, batch + k, n - k);
+      if (!m)
+        sched_yield();
+      k += m;
+    }
+    i += n;
+  }
+  return NULL;
+}
+
+static void *mpmcq_consume(void *arg)
+{
+  struct mpmcq_worker *w = arg;
+  uint64_t batch[8], last[MPMCQ_NPROD];
+  size_t i, n;
+
+  for (i = 0; i < MPMCQ_NPROD; i++)
+    last[i] = UINT64_MAX;
+  while (atomic_load(w->left) > 0) {
+    n = mpmcq_try_deq_n(w->q, batch, (w->id & 1) ? 8 : 1);
+    if (!n) {
+      sched_yield();
+      continue;
+    }
+    atomic_fetch_sub(w->left, n);
+    for (i = 0; i < n; i++) {
+      uint64_t p = batch[i] >> 32, s = batch[i] & 0xffffffffu;
+      if (p >= MPMCQ_NPROD || (last[p] != UINT64_MAX && s <= last[p]))
+        w->ordered = 0;
+      else
+        last[p] = s;
+      w->sum += batch[i];
+    }
+  }
+  return NULL;
+}
+
+UTEST_CASE(concurrent)
+{
+  {
+    struct mpmcq q;
+    struct mpmcq_worker prod[MPMCQ_NPROD], cons[MPMCQ_NCONS];
+    pthread_t tprod[MPMCQ_NPROD], tcons[MPMCQ_NCONS];
+    atomic_size_t left;
+    uint64_t sum = 0, want = 0;
+    size_t i;
+
+    EXPECT_EQ_INT(mpmcq_init(&q, sizeof(uint64_t), 64, NULL), 0);
+    atomic_init(&left, (size_t)MPMCQ_NPROD * MPMCQ_NITEM);
+    for (i = 0; i < MPMCQ_NCONS; i++) {
+      cons[i] = (struct mpmcq_worker){&q, &left, i, 0, 1};
+      EXPECT_EQ_INT(pthread_create(&tcons[i], NULL, mpmcq_consume, &cons[i]),
+                    0);
+    }
+    for (i = 0; i < MPMCQ_NPROD; i++) {
+      prod[i] = (struct mpmcq_worker){&q, &left, i, 0, 1};
+      EXPECT_EQ_INT(pthread_create(&tprod[i], NULL, mpmcq_produce, &prod[i]),
+                    0);
+    }
+    for (i = 0; i < MPMCQ_NPROD; i++)
+      pthread_join(tprod[i], NULL);
+    for (i = 0; i < MPMCQ_NCONS; i++) {
+      pthread_join(tcons[i], NULL);
+      EXPECT_TRUE(cons[i].ordered);
+      sum += cons[i].sum;
+    }
+    for (i = 0; i < MPMCQ_NPROD; i++)
+      want += i * MPMCQ_NITEM * (1ULL << 32) +
+              (uint64_t)MPMCQ_NITEM * (MPMCQ_NITEM - 1) / 2;
+    EXPECT_EQ_UINT(sum, want);
+    EXPECT_EQ_UINT(mpmcq_size(&q), 0);
+    mpmcq_fini(&q);
+  }
+}
@@ -0,0 +1,8 @@
+#include "unit/basic.h"
+#include "unit/integration.h"
+
+UTEST_SUITE(radixheap)
+{
+  UTEST_RUNCASE(basic);
+  UTEST_RUNCASE(integration);
+}
@@ -0,0 +1,77 @@
+#include <radixheap.h>
+#include <utest.h>
+
+static int rh_dtor_n;
+static void rh_dtor_inc(void *p)
+{
+  (void)p;
+  rh_dtor_n++;
+}
+
+UTEST_CASE(basic)
+{
+  {
+    struct radixheap rh;
+
+    EXPECT_EQ_INT(radixheap_init(NULL, sizeof(int), NULL), -1);
+    EXPECT_EQ_INT(radixheap_init(&rh, 0, NULL), -1);
+    EXPECT_EQ_INT(radixheap_init(&rh, sizeof(int), NULL), 0);
+    EXPECT_TRUE(radixheap_empty(&rh));
+    EXPECT_EQ_UINT(radixheap_size(&rh), 0);
+    EXPECT_NULL(radixheap_peek(&rh, NULL));
+    EXPECT_EQ_INT(radixheap_pop(&rh, NULL, NULL), -1);
+    EXPECT_EQ_INT(radixheap_push(&rh, 1, NULL), -1);
+    radixheap_fini(&rh);
+  }
+
+  {
+    struct radixheap rh;
+    uint64_t keys[] = {50, 7, 7, 1000000, 0, 3, UINT64_MAX, 64};
+    uint64_t sorted[] = {0, 3, 7, 7, 50, 64, 1000000, UINT64_MAX};
+    uint64_t key;
+    int x, out;
+    size_t i;
+
+    EXPECT_EQ_INT(radixheap_init(&rh, sizeof(int), NULL), 0);
+    for (i = 0; i < 8; i++) {
+      x = (int)i;
+      EXPECT_EQ_INT(radixheap_push(&rh, keys[i], &x), 0);
+    }
+    EXPECT_EQ_UINT(radixheap_size(&rh), 8);
+    EXPECT_NOTNULL(radixheap_peek(&rh, &key));
+    EXPECT_EQ_UINT(key, 0);
+    EXPECT_EQ_INT(*(int *)radixheap_peek(&rh, NULL), 4);
+    for (i = 0; i < 8; i++) {
+      key = 1;
+      out = -1;
+      EXPECT_EQ_INT(radixheap_pop(&rh, &key, &out), 0);
+      EXPECT_EQ_UINT(key, sorted[i]);
+      EXPECT_EQ_UINT(keys[out], key);
+    }
+    EXPECT_TRUE(radixheap_empty(&rh));
+    radixheap_fini(&rh);
+  }
+
+  {
+    struct radixheap rh;
+    int x = 1;
+
+    rh_dtor_n = 0;
+    EXPECT_EQ_INT(radixheap_init(&rh, sizeof(int), rh_dtor_inc), 0);
+    EXPECT_EQ_INT(radixheap_push(&rh, 10, &x), 0);
+    EXPECT_EQ_INT(radixheap_push(&rh, 20, &x), 0);
+    EXPECT_EQ_INT(radixheap_push(&rh, 30, &x), 0);
+    EXPECT_EQ_INT(radixheap_pop(&rh, NULL, NULL), 0);
+    EXPECT_EQ_INT(rh_dtor_n, 1);
+
+    /* keys below the last popped key break monotonicity */
+    EXPECT_EQ_INT(radixheap_push(&rh, 9, &x), -1);
+    EXPECT_EQ_INT(radixheap_push(&rh, 10, &x), 0);
+    radixheap_clear(&rh);
+    EXPECT_EQ_INT(rh_dtor_n, 4);
+    EXPECT_TRUE(radixheap_empty(&rh));
+    EXPECT_EQ_INT(radixheap_push(&rh, 10, &x), 0);
+    radixheap_fini(&rh);
+    EXPECT_EQ_INT(rh_dtor_n, 5);
+  }
+}
@@ -0,0 +1,64 @@
+#include <heap.h>
+#include <radixheap.h>
+#include <utest.h>
+
+struct rh_timer {
+  uint64_t when;
+  int id;
+  char pad[36];
+};
+
+static int rh_cmp_timer(void *a, void *b)
+{
+  uint64_t x = ((struct rh_timer *)a)->when;
+  uint64_t y = ((struct rh_timer *)b)->when;
+  return (x > y) - (x < y);
+}
+
+UTEST_CASE(integration)
+{
+  {
+    /* Event loop simulation: every pop schedules new timers in the future,
+       the radix heap must agree with struct heap on the pop order */
+    struct radixheap rh;
+    struct heap h;
+    uint64_t seed = 99u;
+    uint64_t now = 0, key;
+    struct rh_timer t, a, b;
+    int i, id = 0;
+
+    EXPECT_EQ_INT(radixheap_init(&rh, sizeof(struct rh_timer), NULL), 0);
+    EXPECT_EQ_INT(heap_init(&h, sizeof(struct rh_timer), rh_cmp_timer, NULL),
+                  0);
+    for (i = 0; i < 64; i++) {
+      seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+      t.when = (seed >> 40) % 5000;
+      t.id = id++;
+      EXPECT_EQ_INT(radixheap_push(&rh, t.when, &t), 0);
+      EXPECT_EQ_INT(heap_push(&h, &t), 0);
+    }
+    for (i = 0; i < 3000; i++) {
+      EXPECT_EQ_INT(radixheap_pop(&rh, &key, &a), 0);
+      EXPECT_EQ_INT(heap_pop(&h, &b), 0);
+      EXPECT_EQ_UINT(key, a.when);
+      EXPECT_EQ_UINT(a.when, b.when);
+      EXPECT_GE_UINT(a.when, now);
+      now = a.when;
+      if (i < 2000) {
+        int j;
+        for (j = 0; j < 2; j++) {
+          seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+          t.when = now + (seed >> 40) % (1u << (j * 12 + 4));
+          t.id = id++;
+          EXPECT_EQ_INT(radixheap_push(&rh, t.when, &t), 0);
+          EXPECT_EQ_INT(heap_push(&h, &t), 0);
+        }
+      }
+      if (radixheap_empty(&rh))
+        break;
+    }
+    EXPECT_EQ_UINT(radixheap_size(&rh), heap_size(&h));
+    radixheap_fini(&rh);
+    heap_fini(&h);
+  }
+}
@@ -0,0 +1,6 @@
+#include "unit/basic.h"
+
+UTEST_SUITE(ring)
+{
+  UTEST_RUNCASE(basic);
+}
@@ -0,0 +1,87 @@
+#include <ring.h>
+#include <utest.h>
+
+static int ring_dtor_n;
+static void ring_dtor_inc(void *p)
+{
+  (void)p;
+  ring_dtor_n++;
+}
+
+UTEST_CASE(basic)
+{
+  {
+    struct ring r;
+    int x = 1;
+
+    EXPECT_EQ_INT(ring_init(NULL, sizeof(int), 4, NULL), -1);
+    EXPECT_EQ_INT(ring_init(&r, 0, 4, NULL), -1);
+    EXPECT_EQ_INT(ring_init(&r, sizeof(int), 0, NULL), -1);
+    EXPECT_EQ_INT(ring_init(&r, sizeof(int), 5, NULL), 0);
+    EXPECT_TRUE(ring_empty(&r));
+    EXPECT_EQ_UINT(ring_capacity(&r), 5);
+    EXPECT_NULL(ring_at(&r, 0));
+    EXPECT_EQ_INT(ring_pop(&r, &x), -1);
+    EXPECT_EQ_INT(ring_push(&r, NULL, NULL), -1);
+    ring_fini(&r);
+  }
+
+  {
+    /* A full ring keeps the last cap samples without reallocating */
+    struct ring r;
+    void *buf, *a, *b;
+    size_t alen, blen, i;
+    int x, old;
+    long sum, want;
+
+    EXPECT_EQ_INT(ring_init(&r, sizeof(int), 5, NULL), 0);
+    buf = r.deq.buf;
+    for (x = 0; x < 5; x++)
+      EXPECT_EQ_INT(ring_push(&r, &x, NULL), 0);
+    EXPECT_TRUE(ring_full(&r));
+    for (x = 5; x < 103; x++) {
+      old = -1;
+      EXPECT_EQ_INT(ring_push(&r, &x, &old), 1);
+      EXPECT_EQ_INT(old, x - 5);
+      EXPECT_EQ_UINT(ring_size(&r), 5);
+      EXPECT_EQ_PTR(r.deq.buf, buf);
+
+      EXPECT_EQ_INT(ring_spans(&r, &a, &alen, &b, &blen), 0);
+      EXPECT_EQ_UINT(alen + blen, 5);
+      sum = 0;
+      for (i = 0; i < alen; i++)
+        sum += ((int *)a)[i];
+      for (i = 0; i < blen; i++)
+        sum += ((int *)b)[i];
+      want = 5L * x - 10;
+      EXPECT_EQ_INT(sum, want);
+    }
+    for (i = 0; i < 5; i++)
+      EXPECT_EQ_INT(*(int *)ring_at(&r, i), 98 + (int)i);
+    EXPECT_EQ_INT(ring_pop(&r, &x), 0);
+    EXPECT_EQ_INT(x, 98);
+    EXPECT_FALSE(ring_full(&r));
+    x = 200;
+    EXPECT_EQ_INT(ring_push(&r, &x, NULL), 0);
+    EXPECT_EQ_INT(*(int *)ring_at(&r, 4), 200);
+    ring_clear(&r);
+    EXPECT_TRUE(ring_empty(&r));
+    ring_fini(&r);
+  }
+
+  {
+    struct ring r;
+    int x = 0, i;
+
+    ring_dtor_n = 0;
+    EXPECT_EQ_INT(ring_init(&r, sizeof(int), 3, ring_dtor_inc), 0);
+    EXPECT_EQ_INT(ring_dtor_n, 0);
+    for (i = 0; i < 10; i++)
+      ring_push(&r, &x, NULL);
+    EXPECT_EQ_INT(ring_dtor_n, 7);
+    ring_push(&r, &x, &x);
+    EXPECT_EQ_INT(ring_dtor_n, 7);
+    ring_fini(&r);
+    EXPECT_EQ_INT(ring_dtor_n, 10);
+  }
+}
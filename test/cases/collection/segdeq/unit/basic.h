@@ -0,0 +1,105 @@
+#include <segdeq.h>
+#include <utest.h>
+
+static int segdeq_dtor_n;
+static void segdeq_dtor_inc(void *p)
+{
+  (void)p;
+  segdeq_dtor_n++;
+}
+
+UTEST_CASE(basic)
+{
+  {
+    struct segdeq dq;
+    int x = 1;
+
+    EXPECT_EQ_INT(segdeq_init(NULL, sizeof(int), NULL), -1);
+    EXPECT_EQ_INT(segdeq_init(&dq, 0, NULL), -1);
+    EXPECT_EQ_INT(segdeq_init(&dq, sizeof(int), NULL), 0);
+    EXPECT_TRUE(segdeq_empty(&dq));
+    EXPECT_NULL(segdeq_front(&dq));
+    EXPECT_NULL(segdeq_at(&dq, 0));
+    EXPECT_EQ_INT(segdeq_popback(&dq, &x), -1);
+    EXPECT_EQ_INT(segdeq_popfront(&dq, &x), -1);
+    EXPECT_EQ_INT(segdeq_pushback(&dq, NULL), -1);
+    segdeq_fini(&dq);
+  }
+
+  {
+    /* Both ends, across many block boundaries */
+    struct segdeq dq;
+    int i, x;
+
+    EXPECT_EQ_INT(segdeq_init(&dq, sizeof(int), NULL), 0);
+    for (i = 0; i < 1000; i++) {
+      x = i;
+      EXPECT_EQ_INT(segdeq_pushback(&dq, &x), 0);
+      x = -i - 1;
+      EXPECT_EQ_INT(segdeq_pushfront(&dq, &x), 0);
+    }
+    EXPECT_EQ_UINT(segdeq_size(&dq), 2000);
+    EXPECT_EQ_INT(*(int *)segdeq_front(&dq), -1000);
+    EXPECT_EQ_INT(*(int *)segdeq_back(&dq), 999);
+    for (i = 0; i < 2000; i++)
+      EXPECT_EQ_INT(*(int *)segdeq_at(&dq, (size_t)i), i - 1000);
+    EXPECT_NULL(segdeq_at(&dq, 2000));
+    for (i = 0; i < 1000; i++) {
+      EXPECT_EQ_INT(segdeq_popfront(&dq, &x), 0);
+      EXPECT_EQ_INT(x, i - 1000);
+    }
+    for (i = 999; i >= 0; i--) {
+      EXPECT_EQ_INT(segdeq_popback(&dq, &x), 0);
+      EXPECT_EQ_INT(x, i);
+    }
+    EXPECT_TRUE(segdeq_empty(&dq));
+    segdeq_fini(&dq);
+  }
+
+  {
+    /* Elements never move while the deque grows at either end */
+    struct segdeq dq;
+    int *ptrs[64];
+    int i, x;
+
+    EXPECT_EQ_INT(segdeq_init(&dq, sizeof(int), NULL), 0);
+    for (i = 0; i < 64; i++) {
+      x = i;
+      EXPECT_EQ_INT(segdeq_pushback(&dq, &x), 0);
+      ptrs[i] = segdeq_back(&dq);
+    }
+    for (i = 0; i < 5000; i++) {
+      x = 7;
+      if (i % 2) {
+        EXPECT_EQ_INT(segdeq_pushback(&dq, &x), 0);
+      } else {
+        EXPECT_EQ_INT(segdeq_pushfront(&dq, &x), 0);
+      }
+    }
+    for (i = 0; i < 64; i++) {
+      EXPECT_EQ_INT(*ptrs[i], i);
+      EXPECT_EQ_PTR(segdeq_at(&dq, 2500 + (size_t)i), ptrs[i]);
+    }
+    segdeq_fini(&dq);
+  }
+
+  {
+    struct segdeq dq;
+    int i, x = 0;
+
+    segdeq_dtor_n = 0;
+    EXPECT_EQ_INT(segdeq_init(&dq, sizeof(int), segdeq_dtor_inc), 0);
+    for (i = 0; i < 100; i++)
+      EXPECT_EQ_INT(segdeq_pushfront(&dq, &x), 0);
+    EXPECT_EQ_INT(segdeq_popfront(&dq, NULL), 0);
+    EXPECT_EQ_INT(segdeq_popback(&dq, NULL), 0);
+    EXPECT_EQ_INT(segdeq_popback(&dq, &x), 0);
+    EXPECT_EQ_INT(segdeq_dtor_n, 2);
+    segdeq_clear(&dq);
+    EXPECT_EQ_INT(segdeq_dtor_n, 99);
+    EXPECT_TRUE(segdeq_empty(&dq));
+    EXPECT_EQ_INT(segdeq_pushback(&dq, &x), 0);
+    segdeq_fini(&dq);
+    EXPECT_EQ_INT(segdeq_dtor_n, 100);
+  }
+}
@@ -0,0 +1,55 @@
+#include <deque.h>
+#include <segdeq.h>
+#include <utest.h>
+
+struct segdeq_rec {
+  int key;
+  char pad[92];
+};
+
+UTEST_CASE(integration)
+{
+  {
+    /* Random operations mirrored on struct deque, with a large element so
+       blocks hold few elements */
+    struct segdeq dq;
+    struct deque ref;
+    struct segdeq_rec r, a, b;
+    unsigned seed = 7u;
+    int i, op;
+
+    EXPECT_EQ_INT(segdeq_init(&dq, sizeof(r), NULL), 0);
+    EXPECT_EQ_INT(deq_init(&ref, sizeof(r), NULL), 0);
+    memset(&r, 0, sizeof(r));
+    for (i = 0; i < 20000; i++) {
+      seed = seed * 1103515245u + 12345u;
+      op = (int)((seed >> 16) % 5);
+      r.key = i;
+      if (op == 0 || (op == 4 && i < 10000)) {
+        EXPECT_EQ_INT(segdeq_pushback(&dq, &r), 0);
+        EXPECT_EQ_INT(deq_pushback(&ref, &r), 0);
+      } else if (op == 1) {
+        EXPECT_EQ_INT(segdeq_pushfront(&dq, &r), 0);
+        EXPECT_EQ_INT(deq_pushfront(&ref, &r), 0);
+      } else if (op == 2) {
+        int ra = segdeq_popback(&dq, &a), rb = deq_popback(&ref, &b);
+        EXPECT_EQ_INT(ra, rb);
+        if (ra == 0)
+          EXPECT_EQ_INT(a.key, b.key);
+      } else {
+        int ra = segdeq_popfront(&dq, &a), rb = deq_popfront(&ref, &b);
+        EXPECT_EQ_INT(ra, rb);
+        if (ra == 0)
+          EXPECT_EQ_INT(a.key, b.key);
+      }
+      EXPECT_EQ_UINT(segdeq_size(&dq), deq_size(&ref));
+      if (!deq_empty(&ref) && i % 97 == 0) {
+        size_t k = (seed >> 8) % deq_size(&ref);
+        EXPECT_EQ_INT(((struct segdeq_rec *)segdeq_at(&dq, k))->key,
+                      ((struct segdeq_rec *)deq_at(&ref, k))->key);
+      }
+    }
+    segdeq_fini(&dq);
+    deq_fini(&ref);
+  }
+}
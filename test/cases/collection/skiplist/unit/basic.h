@@ -0,0 +1,113 @@
+#include <skiplist.h>
+#include <stdint.h>
+#include <utest.h>
+
+static int cmp_int(void *a, void *b)
+{
+  int x = *(int *)a, y = *(int *)b;
+  return (x > y) - (x < y);
+}
+
+static int dtor_key_n;
+static int dtor_val_n;
+
+static void dtor_key(void *p)
+{
+  (void)p;
+  dtor_key_n++;
+}
+
+static void dtor_val(void *p)
+{
+  (void)p;
+  dtor_val_n++;
+}
+
+UTEST_CASE(basic)
+{
+  struct skiplist sl;
+  struct skiplist_fns fns = {cmp_int, dtor_key, dtor_val};
+  struct skiplist_fns nocmp = {NULL, NULL, NULL};
+  struct skiplist_iter it;
+  int keys[1000], vals[1000], probe, i, prev;
+  void *k, *v;
+
+  EXPECT_EQ_INT(skiplist_init(NULL, &fns), -1);
+  EXPECT_EQ_INT(skiplist_init(&sl, &nocmp), -1);
+  EXPECT_EQ_INT(skiplist_init(&sl, &fns), 0);
+  EXPECT_EQ_UINT(skiplist_size(&sl), 0);
+  probe = 1;
+  EXPECT_NULL(skiplist_find(&sl, &probe));
+  EXPECT_EQ_INT(skiplist_remove(&sl, &probe, NULL), -1);
+  EXPECT_EQ_INT(skiplist_insert(&sl, NULL, NULL), -1);
+  EXPECT_EQ_INT(skiplist_iter_init(&it, &sl), 0);
+  EXPECT_EQ_INT(skiplist_iter_get(&it, &k, &v), -1);
+  skiplist_iter_fini(&it);
+
+  dtor_key_n = dtor_val_n = 0;
+  for (i = 0; i < 1000; i++) {
+    keys[i] = (i * 7919) % 1000;
+    vals[i] = keys[i] + 1;
+    EXPECT_EQ_INT(skiplist_insert(&sl, &keys[i], &vals[i]), 0);
+  }
+  EXPECT_EQ_UINT(skiplist_size(&sl), 1000);
+  probe = 500;
+  EXPECT_EQ_INT(skiplist_insert(&sl, &probe, NULL), -1);
+  EXPECT_EQ_INT(dtor_key_n, 0);
+  for (probe = 0; probe < 1000; probe++)
+    EXPECT_EQ_INT(*(int *)skiplist_find(&sl, &probe), probe + 1);
+  probe = 1000;
+  EXPECT_FALSE(skiplist_contains(&sl, &probe));
+  probe = -1;
+  EXPECT_NULL(skiplist_find(&sl, &probe));
+
+  /* In-order walk, then a seek between and onto keys */
+  EXPECT_EQ_INT(skiplist_iter_init(&it, &sl), 0);
+  prev = -1;
+  for (i = 0; skiplist_iter_get(&it, &k, NULL) == 0; i++) {
+    EXPECT_EQ_INT(*(int *)k, prev + 1);
+    prev = *(int *)k;
+    skiplist_iter_inc(&it);
+  }
+  EXPECT_EQ_INT(i, 1000);
+  skiplist_iter_inc(&it);
+  EXPECT_EQ_INT(skiplist_iter_get(&it, &k, NULL), -1);
+  skiplist_iter_fini(&it);
+
+  /* Remove every even key, half of them handing the value back */
+  for (probe = 0; probe < 1000; probe += 2) {
+    if (probe % 4) {
+      v = NULL;
+      EXPECT_EQ_INT(skiplist_remove(&sl, &probe, &v), 0);
+      EXPECT_EQ_INT(*(int *)v, probe + 1);
+    } else {
+      EXPECT_EQ_INT(skiplist_remove(&sl, &probe, NULL), 0);
+    }
+    EXPECT_EQ_INT(skiplist_remove(&sl, &probe, NULL), -1);
+    EXPECT_FALSE(skiplist_contains(&sl, &probe));
+  }
+  EXPECT_EQ_UINT(skiplist_size(&sl), 500);
+
+  probe = 100;
+  EXPECT_EQ_INT(skiplist_iter_seek(&it, &sl, &probe), 0);
+  EXPECT_EQ_INT(skiplist_iter_get(&it, &k, &v), 0);
+  EXPECT_EQ_INT(*(int *)k, 101);
+  EXPECT_EQ_INT(*(int *)v, 102);
+  skiplist_iter_inc(&it);
+  EXPECT_EQ_INT(skiplist_iter_get(&it, &k, NULL), 0);
+  EXPECT_EQ_INT(*(int *)k, 103);
+  skiplist_iter_fini(&it);
+  probe = 999;
+  EXPECT_EQ_INT(skiplist_iter_seek(&it, &sl, &probe), 0);
+  EXPECT_EQ_INT(skiplist_iter_get(&it, &k, NULL), 0);
+  EXPECT_EQ_INT(*(int *)k, 999);
+  skiplist_iter_inc(&it);
+  EXPECT_EQ_INT(skiplist_iter_get(&it, &k, NULL), -1);
+  skiplist_iter_fini(&it);
+
+  /* Removed entries are destroyed at the latest by fini, values handed back
+     are not */
+  skiplist_fini(&sl);
+  EXPECT_EQ_INT(dtor_key_n, 1000);
+  EXPECT_EQ_INT(dtor_val_n, 750);
+}
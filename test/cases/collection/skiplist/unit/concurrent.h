@@ -0,0 +1,157 @@
+#include <pthread.h>
+#include <skiplist.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <utest.h>
+
+#define SKIPLIST_NTHREAD 4
+#define SKIPLIST_NKEY 2048
+#define SKIPLIST_NOPS 40000
+
+struct skiplist_worker {
+  struct skiplist *sl;
+  atomic_int *stop;
+  unsigned id;
+  long net;    /* Successful inserts minus successful removes */
+  int ok;      /* Every result was consistent */
+  size_t scan; /* Entries seen by the scanner */
+};
+
+/* Keys are heap copies freed by the list, a node reclaimed while another
+   thread still reads it shows up as a use after free */
+static int *mkkey(int v)
+{
+  int *p = malloc(sizeof *p);
+  if (p)
+    *p = v;
+  return p;
+}
+
+/* Disjoint keys: each worker owns every SKIPLIST_NTHREAD-th key, so all of
+   its inserts and then removes must succeed */
+static void *skiplist_own(void *arg)
+{
+  struct skiplist_worker *w = arg;
+  for (int v = (int)w->id; v < SKIPLIST_NKEY; v += SKIPLIST_NTHREAD) {
+    int *key = mkkey(v);
+    if (!key || skiplist_insert(w->sl, key, (void *)(intptr_t)v) != 0)
+      w->ok = 0;
+  }
+  for (int v = (int)w->id; v < SKIPLIST_NKEY; v += SKIPLIST_NTHREAD) {
+    void *val = NULL;
+    if (skiplist_remove(w->sl, &v, &val) != 0 || (intptr_t)val != v)
+      w->ok = 0;
+  }
+  return NULL;
+}
+
+/* Random inserts, removes and lookups on shared keys */
+static void *skiplist_churn(void *arg)
+{
+  struct skiplist_worker *w = arg;
+  unsigned seed = w->id * 2654435761u + 1;
+
+  for (int i = 0; i < SKIPLIST_NOPS; i++) {
+    seed = seed * 1103515245u + 12345u;
+    int v = (int)((seed >> 16) % SKIPLIST_NKEY), op = (seed >> 8) % 3;
+    if (op == 0) {
+      int *key = mkkey(v);
+      if (skiplist_insert(w->sl, key, (void *)(intptr_t)v) == 0)
+        w->net++;
+      else
+        free(key);
+    } else if (op == 1) {
+      void *val = NULL;
+      if (skiplist_remove(w->sl, &v, &val) == 0) {
+        w->net--;
+        if ((intptr_t)val != v)
+          w->ok = 0;
+      }
+    } else {
+      void *val = skiplist_find(w->sl, &v);
+      if (val && (intptr_t)val != v)
+        w->ok = 0;
+    }
+  }
+  return NULL;
+}
+
+/* Ordered scans while the others write, keys must strictly increase and the
+   size stays within the key range plus one pending insert per writer */
+static void *skiplist_scan(void *arg)
+{
+  struct skiplist_worker *w = arg;
+  struct skiplist_iter it;
+  void *k;
+
+  while (!atomic_load(w->stop)) {
+    int prev = -1;
+    if (skiplist_size(w->sl) > SKIPLIST_NKEY + SKIPLIST_NTHREAD)
+      w->ok = 0;
+    skiplist_iter_init(&it, w->sl);
+    while (skiplist_iter_get(&it, &k, NULL) == 0) {
+      if (*(int *)k <= prev)
+        w->ok = 0;
+      prev = *(int *)k;
+      w->scan++;
+      skiplist_iter_inc(&it);
+    }
+    skiplist_iter_fini(&it);
+  }
+  return NULL;
+}
+
+UTEST_CASE(concurrent)
+{
+  struct skiplist sl;
+  struct skiplist_fns fns = {cmp_int, free, NULL};
+  struct skiplist_worker w[SKIPLIST_NTHREAD + 1];
+  pthread_t t[SKIPLIST_NTHREAD + 1];
+  struct skiplist_iter it;
+  atomic_int stop;
+  long net = 0;
+  size_t n;
+  int i, prev;
+  void *k;
+
+  EXPECT_EQ_INT(skiplist_init(&sl, &fns), 0);
+  atomic_init(&stop, 0);
+  for (i = 0; i <= SKIPLIST_NTHREAD; i++)
+    w[i] = (struct skiplist_worker){&sl, &stop, (unsigned)i, 0, 1, 0};
+
+  for (i = 0; i < SKIPLIST_NTHREAD; i++)
+    EXPECT_EQ_INT(pthread_create(&t[i], NULL, skiplist_own, &w[i]), 0);
+  for (i = 0; i < SKIPLIST_NTHREAD; i++)
+    pthread_join(t[i], NULL);
+  for (i = 0; i < SKIPLIST_NTHREAD; i++)
+    EXPECT_TRUE(w[i].ok);
+  EXPECT_EQ_UINT(skiplist_size(&sl), 0);
+
+  for (i = 0; i < SKIPLIST_NTHREAD; i++)
+    EXPECT_EQ_INT(pthread_create(&t[i], NULL, skiplist_churn, &w[i]), 0);
+  EXPECT_EQ_INT(pthread_create(&t[i], NULL, skiplist_scan, &w[i]), 0);
+  for (i = 0; i < SKIPLIST_NTHREAD; i++)
+    pthread_join(t[i], NULL);
+  atomic_store(&stop, 1);
+  pthread_join(t[SKIPLIST_NTHREAD], NULL);
+
+  for (i = 0; i <= SKIPLIST_NTHREAD; i++) {
+    EXPECT_TRUE(w[i].ok);
+    net += w[i].net;
+  }
+  EXPECT_GT_UINT(w[SKIPLIST_NTHREAD].scan, 0);
+  EXPECT_EQ_UINT(skiplist_size(&sl), (size_t)net);
+
+  /* Quiescent now, the iteration must match the size exactly */
+  EXPECT_EQ_INT(skiplist_iter_init(&it, &sl), 0);
+  for (n = 0, prev = -1; skiplist_iter_get(&it, &k, NULL) == 0; n++) {
+    EXPECT_GT_INT(*(int *)k, prev);
+    EXPECT_TRUE(skiplist_contains(&sl, k));
+    prev = *(int *)k;
+    skiplist_iter_inc(&it);
+  }
+  skiplist_iter_fini(&it);
+  EXPECT_EQ_UINT(n, (size_t)net);
+  skiplist_fini(&sl);
+}
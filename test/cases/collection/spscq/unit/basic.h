@@ -0,0 +1,74 @@
+#include <spscq.h>
+#include <utest.h>
+
+static int spscq_dtor_n;
+static void spscq_dtor_inc(void *p)
+{
+  (void)p;
+  spscq_dtor_n++;
+}
+
+UTEST_CASE(basic)
+{
+  {
+    struct spscq q;
+    int x = 1;
+
+    EXPECT_EQ_INT(spscq_init(NULL, sizeof(int), 8, NULL), -1);
+    EXPECT_EQ_INT(spscq_init(&q, 0, 8, NULL), -1);
+    EXPECT_EQ_INT(spscq_init(&q, sizeof(int), 1, NULL), 0);
+    EXPECT_EQ_UINT(spscq_capacity(&q), 1);
+    EXPECT_EQ_INT(spscq_deq(&q, &x), -1);
+    EXPECT_EQ_INT(spscq_enq(&q, NULL), -1);
+    EXPECT_EQ_INT(spscq_enq(&q, &x), 0);
+    EXPECT_EQ_INT(spscq_enq(&q, &x), -1);
+    EXPECT_EQ_UINT(spscq_size(&q), 1);
+    spscq_fini(&q);
+
+    EXPECT_EQ_INT(spscq_init(&q, sizeof(int), 100, NULL), 0);
+    EXPECT_EQ_UINT(spscq_capacity(&q), 128);
+    spscq_fini(&q);
+  }
+
+  {
+    /* Spans wrapping around the end of the buffer */
+    struct spscq q;
+    int in[16], out[16], i, next = 0, want = 0, round;
+
+    EXPECT_EQ_INT(spscq_init(&q, sizeof(int), 8, NULL), 0);
+    for (round = 0; round < 50; round++) {
+      size_t n = (size_t)(round % 7) + 1, m;
+      for (i = 0; i < (int)n; i++)
+        in[i] = next + i;
+      m = spscq_enq_n(&q, in, n);
+      EXPECT_LE_INT((int)m, (int)n);
+      next += (int)m;
+      m = spscq_deq_n(&q, out, (size_t)(round % 5) + 1);
+      for (i = 0; i < (int)m; i++)
+        EXPECT_EQ_INT(out[i], want++);
+    }
+    while (spscq_deq(&q, &i) == 0)
+      EXPECT_EQ_INT(i, want++);
+    EXPECT_EQ_INT(want, next);
+    EXPECT_EQ_UINT(spscq_enq_n(&q, in, 16), 8);
+    EXPECT_EQ_UINT(spscq_enq_n(&q, in, 1), 0);
+    EXPECT_EQ_UINT(spscq_deq_n(&q, out, 16), 8);
+    EXPECT_EQ_UINT(spscq_deq_n(&q, out, 1), 0);
+    spscq_fini(&q);
+  }
+
+  {
+    struct spscq q;
+    int x = 3;
+
+    spscq_dtor_n = 0;
+    EXPECT_EQ_INT(spscq_init(&q, sizeof(int), 4, spscq_dtor_inc), 0);
+    EXPECT_EQ_INT(spscq_enq(&q, &x), 0);
+    EXPECT_EQ_INT(spscq_enq(&q, &x), 0);
+    EXPECT_EQ_INT(spscq_enq(&q, &x), 0);
+    EXPECT_EQ_INT(spscq_deq(&q, NULL), 0);
+    EXPECT_EQ_INT(spscq_dtor_n, 1);
+    spscq_fini(&q);
+    EXPECT_EQ_INT(spscq_dtor_n, 3);
+  }
+}
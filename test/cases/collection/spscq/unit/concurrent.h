@@ -0,0 +1,70 @@
+#include <pthread.h>
+#include <sched.h>
+#include <spscq.h>
+#include <stdint.h>
+#include <utest.h>
+
+#define SPSCQ_NITEM 500000
+
+struct spscq_worker {
+  struct spscq *q;
+  int ordered; /* Consumer saw 0, 1, 2, ... without gaps */
+};
+
+static void *spscq_produce(void *arg)
+{
+  struct spscq_worker *w = arg;
+  uint32_t batch[32];
+  size_t i = 0, k, n;
+
+  while (i < SPSCQ_NITEM) {
+    n = i % 32 + 1;
+    if (n > SPSCQ_NITEM - i)
+      n = SPSCQ_NITEM - i;
+    for (k = 0; k < n; k++)
+      batch[k] = (uint32_t)(i + k);
+    k = 0;
+    while (k < n) {
+      size_t m = spscq_enq_n(w->q, batch + k, n - k);
+      if (!m)
+        sched_yield();
+      k += m;
+    }
+    i += n;
+  }
+  return NULL;
+}
+
+UTEST_CASE(concurrent)
+{
+  {
+    struct spscq q;
+    struct spscq_worker w;
+    pthread_t t;
+    uint32_t batch[24], x;
+    size_t got = 0, i, n;
+
+    EXPECT_EQ_INT(spscq_init(&q, sizeof(uint32_t), 256, NULL), 0);
+    w = (struct spscq_worker){&q, 1};
+    EXPECT_EQ_INT(pthread_create(&t, NULL, spscq_produce, &w), 0);
+    while (got < SPSCQ_NITEM) {
+      if (got % 3 == 0) {
+        if (spscq_deq(&q, &x) == -1) {
+          sched_yield();
+          continue;
+        }
+        w.ordered &= x == got++;
+        continue;
+      }
+      n = spscq_deq_n(&q, batch, 24);
+      if (!n)
+        sched_yield();
+      for (i = 0; i < n; i++)
+        w.ordered &= batch[i] == got++;
+    }
+    pthread_join(t, NULL);
+    EXPECT_TRUE(w.ordered);
+    EXPECT_EQ_UINT(spscq_size(&q), 0);
+    spscq_fini(&q);
+  }
+}
@@ -165,6 +165,31 @@ UTEST_CASE(basic)
     vec_fini(&v);
   }
 
+  {
+    struct vector v;
+    size_t cap;
+    int i;
+
+    EXPECT_EQ_INT(vec_init(&v, sizeof(int), NULL), 0);
+    EXPECT_EQ_INT(vec_reserve(&v, 0), 0);
+    EXPECT_EQ_UINT(vec_capacity(&v), 0);
+    EXPECT_EQ_INT(vec_reserve(&v, 1), 0);
+    EXPECT_TRUE(vec_empty(&v));
+    cap = vec_capacity(&v);
+    EXPECT_GE_UINT(cap, 1);
+    EXPECT_EQ_INT(vec_reserve(&v, cap + 1), 0);
+    EXPECT_GE_UINT(vec_capacity(&v), 2 * cap);
+    EXPECT_EQ_INT(vec_reserve(&v, 1000), 0);
+    EXPECT_GE_UINT(vec_capacity(&v), 1000);
+    EXPECT_TRUE(vec_empty(&v));
+    cap = vec_capacity(&v);
+    for (i = 0; i < 1000; i++)
+      EXPECT_EQ_INT(vec_pushback(&v, &i), 0);
+    EXPECT_EQ_UINT(vec_capacity(&v), cap);
+    EXPECT_EQ_INT(*(int *)vec_back(&v), 999);
+    vec_fini(&v);
+  }
+
   {
     struct vector v;
     int x;
@@ -376,6 +401,7 @@ UTEST_CASE(basic)
 
     EXPECT_EQ_INT(vec_resize(NULL, 1), -1);
     EXPECT_EQ_INT(vec_shrink(NULL), -1);
+    EXPECT_EQ_INT(vec_reserve(NULL, 1), -1);
     EXPECT_EQ_INT(vec_pushback(NULL, &x), -1);
     EXPECT_EQ_INT(vec_insert(NULL, 0, &x), -1);
     EXPECT_EQ_INT(vec_remove(NULL, 0, NULL), -1);
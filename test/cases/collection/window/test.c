@@ -0,0 +1,8 @@
+#include "unit/agg.h"
+#include "unit/mono.h"
+
+UTEST_SUITE(window)
+{
+  UTEST_RUNCASE(mono);
+  UTEST_RUNCASE(agg);
+}
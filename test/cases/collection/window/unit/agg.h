@@ -0,0 +1,103 @@
+#include <stdint.h>
+#include <utest.h>
+#include <window.h>
+
+static void win_op_sum(void *dst, void *a, void *b)
+{
+  *(int64_t *)dst = *(int64_t *)a + *(int64_t *)b;
+}
+
+/* Composition of affine maps x -> m * x + c modulo a prime, associative but
+   not commutative, so the fold order is checked too */
+struct win_affine {
+  uint64_t m, c;
+};
+
+#define WIN_P 1000003u
+
+static void win_op_affine(void *dst, void *a, void *b)
+{
+  struct win_affine *f = a, *g = b;
+  struct win_affine *h = dst;
+  h->m = g->m * f->m % WIN_P;
+  h->c = (g->m * f->c + g->c) % WIN_P;
+}
+
+UTEST_CASE(agg)
+{
+  {
+    struct winagg w;
+    int64_t x = 3, out = 0;
+
+    EXPECT_EQ_INT(winagg_init(NULL, sizeof(int64_t), win_op_sum), -1);
+    EXPECT_EQ_INT(winagg_init(&w, 0, win_op_sum), -1);
+    EXPECT_EQ_INT(winagg_init(&w, sizeof(int64_t), NULL), -1);
+    EXPECT_EQ_INT(winagg_init(&w, sizeof(int64_t), win_op_sum), 0);
+    EXPECT_EQ_INT(winagg_query(&w, &out), -1);
+    EXPECT_EQ_INT(winagg_evict(&w, &out), -1);
+    EXPECT_EQ_INT(winagg_push(&w, &x), 0);
+    EXPECT_EQ_INT(winagg_query(&w, &out), 0);
+    EXPECT_EQ_INT(out, 3);
+    x = 4;
+    EXPECT_EQ_INT(winagg_push(&w, &x), 0);
+    EXPECT_EQ_INT(winagg_query(&w, &out), 0);
+    EXPECT_EQ_INT(out, 7);
+    EXPECT_EQ_INT(winagg_evict(&w, &out), 0);
+    EXPECT_EQ_INT(out, 3);
+    x = 10;
+    EXPECT_EQ_INT(winagg_push(&w, &x), 0);
+    EXPECT_EQ_INT(winagg_query(&w, &out), 0);
+    EXPECT_EQ_INT(out, 14);
+    winagg_clear(&w);
+    EXPECT_TRUE(winagg_empty(&w));
+    EXPECT_EQ_INT(winagg_query(&w, &out), -1);
+    winagg_fini(&w);
+  }
+
+  {
+    /* Sum and affine composition over sliding windows of several sizes */
+    size_t wins[] = {1, 3, 50, 777};
+    size_t t, i, j;
+
+    for (t = 0; t < sizeof wins / sizeof wins[0]; t++) {
+      struct winagg sum, aff;
+      struct win_affine f[2000], got, want;
+      int64_t v, s, ws;
+      uint64_t seed = 5u + t;
+
+      EXPECT_EQ_INT(winagg_init(&sum, sizeof(int64_t), win_op_sum), 0);
+      EXPECT_EQ_INT(winagg_init(&aff, sizeof(struct win_affine), win_op_affine),
+                    0);
+      ws = 0;
+      for (i = 0; i < 2000; i++) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        f[i].m = (seed >> 33) % WIN_P;
+        f[i].c = (seed >> 13) % WIN_P;
+        v = (int64_t)(seed >> 40) - (1 << 23);
+        EXPECT_EQ_INT(winagg_push(&sum, &v), 0);
+        EXPECT_EQ_INT(winagg_push(&aff, &f[i]), 0);
+        ws += v;
+        if (winagg_size(&sum) > wins[t]) {
+          int64_t old;
+          EXPECT_EQ_INT(winagg_evict(&sum, &old), 0);
+          EXPECT_EQ_INT(winagg_evict(&aff, NULL), 0);
+          ws -= old;
+        }
+        EXPECT_EQ_INT(winagg_query(&sum, &s), 0);
+        EXPECT_EQ_INT(s, ws);
+
+        want = f[i + 1 - winagg_size(&aff)];
+        for (j = i + 2 - winagg_size(&aff); j <= i; j++) {
+          struct win_affine tmp;
+          win_op_affine(&tmp, &want, &f[j]);
+          want = tmp;
+        }
+        EXPECT_EQ_INT(winagg_query(&aff, &got), 0);
+        EXPECT_EQ_UINT(got.m, want.m);
+        EXPECT_EQ_UINT(got.c, want.c);
+      }
+      winagg_fini(&sum);
+      winagg_fini(&aff);
+    }
+  }
+}
@@ -0,0 +1,75 @@
+#include <stdint.h>
+#include <utest.h>
+#include <window.h>
+
+static int win_cmp_asc(void *a, void *b)
+{
+  int x = *(int *)a, y = *(int *)b;
+  return (x > y) - (x < y);
+}
+
+static int win_cmp_desc(void *a, void *b) { return win_cmp_asc(b, a); }
+
+UTEST_CASE(mono)
+{
+  {
+    struct winmono w;
+    int x = 1;
+
+    EXPECT_EQ_INT(winmono_init(NULL, sizeof(int), win_cmp_asc), -1);
+    EXPECT_EQ_INT(winmono_init(&w, 0, win_cmp_asc), -1);
+    EXPECT_EQ_INT(winmono_init(&w, sizeof(int), NULL), -1);
+    EXPECT_EQ_INT(winmono_init(&w, sizeof(int), win_cmp_asc), 0);
+    EXPECT_TRUE(winmono_empty(&w));
+    EXPECT_NULL(winmono_query(&w));
+    EXPECT_EQ_INT(winmono_evict(&w), -1);
+    EXPECT_EQ_INT(winmono_push(&w, NULL), -1);
+    EXPECT_EQ_INT(winmono_push(&w, &x), 0);
+    EXPECT_EQ_INT(*(int *)winmono_query(&w), 1);
+    winmono_clear(&w);
+    EXPECT_TRUE(winmono_empty(&w));
+    EXPECT_NULL(winmono_query(&w));
+    winmono_fini(&w);
+  }
+
+  {
+    /* Rolling min and max over fixed windows against a brute-force scan */
+    size_t wins[] = {1, 2, 7, 64, 1000};
+    int vals[3000];
+    unsigned seed = 42u;
+    size_t t, i, j;
+
+    for (i = 0; i < 3000; i++) {
+      seed = seed * 1103515245u + 12345u;
+      vals[i] = (int)((seed >> 16) % 200) - 100;
+    }
+    for (t = 0; t < sizeof wins / sizeof wins[0]; t++) {
+      struct winmono lo, hi;
+      EXPECT_EQ_INT(winmono_init(&lo, sizeof(int), win_cmp_asc), 0);
+      EXPECT_EQ_INT(winmono_init(&hi, sizeof(int), win_cmp_desc), 0);
+      for (i = 0; i < 3000; i++) {
+        int mn = INT32_MAX, mx = INT32_MIN;
+        EXPECT_EQ_INT(winmono_push(&lo, &vals[i]), 0);
+        EXPECT_EQ_INT(winmono_push(&hi, &vals[i]), 0);
+        if (winmono_size(&lo) > wins[t]) {
+          EXPECT_EQ_INT(winmono_evict(&lo), 0);
+          EXPECT_EQ_INT(winmono_evict(&hi), 0);
+        }
+        EXPECT_EQ_UINT(winmono_size(&lo), i + 1 < wins[t] ? i + 1 : wins[t]);
+        for (j = i + 1 - winmono_size(&lo); j <= i; j++) {
+          mn = vals[j] < mn ? vals[j] : mn;
+          mx = vals[j] > mx ? vals[j] : mx;
+        }
+        EXPECT_EQ_INT(*(int *)winmono_query(&lo), mn);
+        EXPECT_EQ_INT(*(int *)winmono_query(&hi), mx);
+      }
+      /* The candidate deque stays far smaller than the window */
+      EXPECT_LE_UINT(deq_size(&lo.deq), winmono_size(&lo));
+      while (!winmono_empty(&lo))
+        EXPECT_EQ_INT(winmono_evict(&lo), 0);
+      EXPECT_NULL(winmono_query(&lo));
+      winmono_fini(&lo);
+      winmono_fini(&hi);
+    }
+  }
+}
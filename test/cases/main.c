@@ -12,12 +12,21 @@
 extern UTEST_SUITE(vector);
 extern UTEST_SUITE(stack);
 extern UTEST_SUITE(deque);
+extern UTEST_SUITE(segdeq);
+extern UTEST_SUITE(ring);
+extern UTEST_SUITE(window);
 extern UTEST_SUITE(queue);
+extern UTEST_SUITE(mpmcq);
+extern UTEST_SUITE(spscq);
+extern UTEST_SUITE(skiplist);
+extern UTEST_SUITE(bqueue);
 extern UTEST_SUITE(slist);
 extern UTEST_SUITE(dlist);
 extern UTEST_SUITE(heap);
+extern UTEST_SUITE(radixheap);
 extern UTEST_SUITE(hashtbl);
 extern UTEST_SUITE(avltree);
+extern UTEST_SUITE(bptree);
 extern UTEST_SUITE(set);
 
 extern UTEST_SUITE(util);
@@ -35,12 +44,21 @@ int main(int argc, char *argv[])
   UTEST_ADDSUITE(vector);
   UTEST_ADDSUITE(stack);
   UTEST_ADDSUITE(deque);
+  UTEST_ADDSUITE(segdeq);
+  UTEST_ADDSUITE(ring);
+  UTEST_ADDSUITE(window);
   UTEST_ADDSUITE(queue);
+  UTEST_ADDSUITE(mpmcq);
+  UTEST_ADDSUITE(spscq);
+  UTEST_ADDSUITE(skiplist);
+  UTEST_ADDSUITE(bqueue);
   UTEST_ADDSUITE(slist);
   UTEST_ADDSUITE(dlist);
   UTEST_ADDSUITE(heap);
+  UTEST_ADDSUITE(radixheap);
   UTEST_ADDSUITE(hashtbl);
   UTEST_ADDSUITE(avltree);
+  UTEST_ADDSUITE(bptree);
   UTEST_ADDSUITE(set);
 
   UTEST_ADDSUITE(util);